@@ -0,0 +1,249 @@
+#define KESIMO_SEM_MAIN
+#include "kesimo.c"
+#define STRASSEN_SEM_MAIN
+#include "strassen.c"
+
+/*
+ * Submissão assíncrona de seleções e multiplicações.
+ *
+ * Compilar com: gcc -O2 -pthread assincrono.c -o assincrono -lm
+ *
+ * Para quem roda um laço de eventos: submeterKesimo/submeterStrassen
+ * retornam na hora com um Trabalho (um "future"); o cálculo roda no
+ * runtime fork-join (forkjoin.h), fora da thread que submeteu.
+ * Na conclusão:
+ * - a função de retorno (se houver) é chamada na thread do despachante;
+ *   o laço de eventos costuma só escrever num pipe/eventfd ali;
+ * - aguardarTrabalho desbloqueia e trabalhoTerminou passa a dar 1.
+ * Os trabalhos rodam um de cada vez, na ordem de submissão, cada um
+ * com até nThreads threads.
+ *
+ * Cancelamento: cancelarTrabalho liga a flag do trabalho. Se ele ainda
+ * estiver na fila, nem começa; se estiver rodando, kesimoMinimo e
+ * strassen desistem na próxima chamada recursiva (em todas as threads
+ * que estiverem com pedaços dele). O resultado de um trabalho cancelado
+ * é lixo: 'arr' fica reorganizado e 'C' incompleta.
+ */
+
+typedef enum {
+    TRABALHO_PENDENTE,
+    TRABALHO_EXECUTANDO,
+    TRABALHO_CONCLUIDO,
+    TRABALHO_CANCELADO
+} EstadoTrabalho;
+
+typedef enum { TRABALHO_KESIMO, TRABALHO_STRASSEN } TipoTrabalho;
+
+typedef struct Trabalho Trabalho;
+typedef void (*AoConcluir)(Trabalho *t, void *dados);
+
+struct Trabalho {
+    TipoTrabalho tipo;
+    int nThreads;
+    // seleção
+    int *arr;
+    int l, r, k;
+    int resultado;
+    // multiplicação
+    int n;
+    int **A, **B, **C;
+
+    atomic_int estado;        // EstadoTrabalho
+    atomic_int cancelado;
+    AoConcluir aoConcluir;
+    void *dados;
+
+    int terminou;             // protegido por 'trava'
+    pthread_mutex_t trava;
+    pthread_cond_t pronto;
+    Trabalho *prox;           // fila do despachante
+};
+
+static struct {
+    Trabalho *inicio, *fim;
+    int iniciado, encerrar;
+    pthread_t thread;
+    pthread_mutex_t trava;
+    pthread_cond_t novo;
+} despachante = {NULL, NULL, 0, 0, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+static void executarTrabalho(Trabalho *t) {
+    if (t->tipo == TRABALHO_KESIMO)
+        t->resultado = kesimoParalelo(t->arr, t->l, t->r, t->k, t->nThreads);
+    else
+        strassenParalelo(t->n, t->A, t->B, t->C, t->nThreads);
+}
+
+static void *cicloDespachante(void *arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&despachante.trava);
+        while (despachante.inicio == NULL && !despachante.encerrar)
+            pthread_cond_wait(&despachante.novo, &despachante.trava);
+        Trabalho *t = despachante.inicio;
+        if (t != NULL) {
+            despachante.inicio = t->prox;
+            if (despachante.inicio == NULL) despachante.fim = NULL;
+        }
+        pthread_mutex_unlock(&despachante.trava);
+        if (t == NULL) break;   // encerrando e a fila esvaziou
+
+        if (!atomic_load(&t->cancelado)) {
+            atomic_store(&t->estado, TRABALHO_EXECUTANDO);
+            const atomic_int *anterior = fjDefinirCancelamento(&t->cancelado);
+            executarTrabalho(t);
+            fjDefinirCancelamento(anterior);
+        }
+        atomic_store(&t->estado, atomic_load(&t->cancelado) ? TRABALHO_CANCELADO : TRABALHO_CONCLUIDO);
+
+        // Primeiro a função de retorno; só depois quem espera pode liberar t.
+        if (t->aoConcluir != NULL) t->aoConcluir(t, t->dados);
+        pthread_mutex_lock(&t->trava);
+        t->terminou = 1;
+        pthread_cond_broadcast(&t->pronto);
+        pthread_mutex_unlock(&t->trava);
+    }
+    return NULL;
+}
+
+static Trabalho *submeter(Trabalho *t, int nThreads, AoConcluir aoConcluir, void *dados) {
+    t->nThreads = nThreads;
+    t->aoConcluir = aoConcluir;
+    t->dados = dados;
+    t->prox = NULL;
+    atomic_init(&t->estado, TRABALHO_PENDENTE);
+    atomic_init(&t->cancelado, 0);
+    pthread_mutex_init(&t->trava, NULL);
+    pthread_cond_init(&t->pronto, NULL);
+
+    pthread_mutex_lock(&despachante.trava);
+    if (!despachante.iniciado) {
+        inicializarRedesSelecao();
+        despachante.encerrar = 0;
+        if (pthread_create(&despachante.thread, NULL, cicloDespachante, NULL) != 0) {
+            pthread_mutex_unlock(&despachante.trava);
+            pthread_mutex_destroy(&t->trava);
+            pthread_cond_destroy(&t->pronto);
+            free(t);
+            return NULL;
+        }
+        despachante.iniciado = 1;
+    }
+    if (despachante.fim != NULL) despachante.fim->prox = t;
+    else despachante.inicio = t;
+    despachante.fim = t;
+    pthread_cond_signal(&despachante.novo);
+    pthread_mutex_unlock(&despachante.trava);
+    return t;
+}
+
+/*
+ * submeterKesimo(arr, l, r, k, nThreads, aoConcluir, dados):
+ * - Agenda kesimoMinimo(arr, l, r, k) e retorna na hora (NULL se falhar).
+ * - 'arr' é reorganizado e deve continuar vivo até o trabalho terminar.
+ * - O valor fica em t->resultado (INT_MAX se k for inválido).
+ */
+Trabalho *submeterKesimo(int arr[], int l, int r, int k, int nThreads, AoConcluir aoConcluir, void *dados) {
+    Trabalho *t = (Trabalho*)calloc(1, sizeof(Trabalho));
+    if (t == NULL) return NULL;
+    t->tipo = TRABALHO_KESIMO;
+    t->arr = arr; t->l = l; t->r = r; t->k = k;
+    t->resultado = INT_MAX;
+    return submeter(t, nThreads, aoConcluir, dados);
+}
+
+/*
+ * submeterStrassen(n, A, B, C, nThreads, aoConcluir, dados):
+ * - Agenda strassen(n, A, B, C) e retorna na hora (NULL se falhar).
+ * - A, B e C devem continuar vivas até o trabalho terminar.
+ */
+Trabalho *submeterStrassen(int n, int **A, int **B, int **C, int nThreads, AoConcluir aoConcluir, void *dados) {
+    Trabalho *t = (Trabalho*)calloc(1, sizeof(Trabalho));
+    if (t == NULL) return NULL;
+    t->tipo = TRABALHO_STRASSEN;
+    t->n = n; t->A = A; t->B = B; t->C = C;
+    return submeter(t, nThreads, aoConcluir, dados);
+}
+
+// Pede o cancelamento (não bloqueia; o trabalho ainda termina "cancelado").
+void cancelarTrabalho(Trabalho *t) {
+    atomic_store(&t->cancelado, 1);
+}
+
+// 1 se o trabalho terminou (concluído ou cancelado) e já pode ser liberado.
+int trabalhoTerminou(Trabalho *t) {
+    pthread_mutex_lock(&t->trava);
+    int terminou = t->terminou;
+    pthread_mutex_unlock(&t->trava);
+    return terminou;
+}
+
+// Bloqueia até o trabalho terminar; retorna o estado final.
+EstadoTrabalho aguardarTrabalho(Trabalho *t) {
+    pthread_mutex_lock(&t->trava);
+    while (!t->terminou) pthread_cond_wait(&t->pronto, &t->trava);
+    pthread_mutex_unlock(&t->trava);
+    return (EstadoTrabalho)atomic_load(&t->estado);
+}
+
+// Libera um trabalho que já terminou (nunca de dentro de aoConcluir).
+void liberarTrabalho(Trabalho *t) {
+    pthread_mutex_destroy(&t->trava);
+    pthread_cond_destroy(&t->pronto);
+    free(t);
+}
+
+// Termina o que estiver na fila e para a thread do despachante.
+void encerrarAssincrono(void) {
+    pthread_mutex_lock(&despachante.trava);
+    if (!despachante.iniciado) {
+        pthread_mutex_unlock(&despachante.trava);
+        return;
+    }
+    despachante.encerrar = 1;
+    pthread_cond_signal(&despachante.novo);
+    pthread_mutex_unlock(&despachante.trava);
+    pthread_join(despachante.thread, NULL);
+    despachante.iniciado = 0;
+}
+
+/* ===================== Exemplo mínimo de uso ===================== */
+
+#ifndef ASSINCRONO_SEM_MAIN
+static void avisar(Trabalho *t, void *dados) {
+    printf("[retorno] %s: %s\n", (const char*)dados,
+           atomic_load(&t->estado) == TRABALHO_CONCLUIDO ? "concluido" : "cancelado");
+}
+
+int main() {
+    // Mediana de 10^6 valores e um produto 256x256 que será abandonado
+    int n = 1000000;
+    int *v = (int*)malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) v[i] = (int)((i * 7919LL) % n);
+
+    int m = 256;
+    int **A = alocarMatriz(m), **B = alocarMatriz(m), **C = alocarMatriz(m);
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < m; j++) { A[i][j] = i + j; B[i][j] = i - j; }
+
+    Trabalho *sel = submeterKesimo(v, 0, n - 1, n / 2, 2, avisar, "mediana");
+    Trabalho *mult = submeterStrassen(m, A, B, C, 2, avisar, "strassen");
+
+    // ...o laço de eventos seguiria atendendo aqui...
+    cancelarTrabalho(mult);
+
+    if (aguardarTrabalho(sel) == TRABALHO_CONCLUIDO)
+        printf("Mediana: %d\n", sel->resultado);   // 499999
+    aguardarTrabalho(mult);
+
+    liberarTrabalho(sel);
+    liberarTrabalho(mult);
+    encerrarAssincrono();
+
+    liberarMatriz(m, A);
+    liberarMatriz(m, B);
+    liberarMatriz(m, C);
+    free(v);
+    return 0;
+}
+#endif
@@ -0,0 +1,307 @@
+#define _GNU_SOURCE
+#define KESIMO_SEM_MAIN
+#include "kesimo.c"
+
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+/*
+ * Benchmark da seleção: roda kesimoMinimo e as estratégias alternativas
+ * contra a referência qsort (ordenar tudo e indexar) sobre várias
+ * distribuições de entrada, vários n e k nas pontas e no meio.
+ *
+ * Compilar com: gcc -O2 -pthread bench_kesimo.c -o bench_kesimo -lm
+ *
+ * Uso: ./bench_kesimo [--nmin N] [--nmax N] [--reps R] [--seed S] [--json]
+ *   - n vai de nmin a nmax multiplicando por 10 (padrão: 10 .. 10^7;
+ *     até 10^9 é aceito, se houver memória para dois vetores de n int).
+ *   - Saída em CSV (padrão) ou JSON, uma linha/objeto por medição.
+ *   - Colunas "comparacoes", "trocas" e "profundidade" valem -1 quando a
+ *     estratégia não conta operações. Compile com -DKESIMO_ESTATISTICAS
+ *     para que as estratégias de kesimo.c as preencham (o tempo medido
+ *     passa a incluir o custo da contagem).
+ *   - "pico_kb" é o pico de memória residente do processo até ali
+ *     (getrusage), não só da medição.
+ */
+
+/* ===================== Geradores de entrada ===================== */
+
+typedef void (*Gerador)(int v[], int n);
+
+static void gerarUniforme(int v[], int n) {
+    for (int i = 0; i < n; i++) v[i] = aleatorioAte(INT_MAX);
+}
+
+static void gerarOrdenado(int v[], int n) {
+    for (int i = 0; i < n; i++) v[i] = i;
+}
+
+static void gerarInvertido(int v[], int n) {
+    for (int i = 0; i < n; i++) v[i] = n - i;
+}
+
+static void gerarIguais(int v[], int n) {
+    for (int i = 0; i < n; i++) v[i] = 42;
+}
+
+static void gerarPoucosUnicos(int v[], int n) {
+    for (int i = 0; i < n; i++) v[i] = aleatorioAte(8);
+}
+
+// Tubo de órgão: sobe até o meio e desce.
+static void gerarOrgao(int v[], int n) {
+    for (int i = 0; i < n; i++) v[i] = i < n / 2 ? i : n - i;
+}
+
+// Dente de serra: rampas crescentes de tamanho ~sqrt(n).
+static void gerarSerra(int v[], int n) {
+    int periodo = (int)sqrt((double)n) + 1;
+    for (int i = 0; i < n; i++) v[i] = i % periodo;
+}
+
+// Entrada de Musser que derruba o quicksort com mediana de 3.
+static void gerarMatadorMediana3(int v[], int n) {
+    int k = n / 2;
+    for (int i = 1; i <= k; i++) {
+        v[i - 1] = (i % 2) ? i : k + i - 1;
+        v[k + i - 1] = 2 * i;
+    }
+    if (n % 2) v[n - 1] = n;
+}
+
+// Zipf (expoente ~1): o valor r aparece com frequência ~1/r.
+static void gerarZipf(int v[], int n) {
+    double logN = log((double)n + 1.0);
+    for (int i = 0; i < n; i++) {
+        double u = (double)aleatorioAte(1 << 30) / (1 << 30);
+        v[i] = (int)exp(u * logN);
+    }
+}
+
+typedef struct {
+    const char *nome;
+    Gerador gerar;
+} Distribuicao;
+
+static const Distribuicao distribuicoes[] = {
+    {"uniforme", gerarUniforme},
+    {"ordenado", gerarOrdenado},
+    {"invertido", gerarInvertido},
+    {"iguais", gerarIguais},
+    {"poucos_unicos", gerarPoucosUnicos},
+    {"orgao", gerarOrgao},
+    {"serra", gerarSerra},
+    {"matador_mediana3", gerarMatadorMediana3},
+    {"zipf", gerarZipf},
+};
+
+/* ===================== Estratégias ===================== */
+
+static long long comparacoesQsort;
+
+static int compararInt(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    comparacoesQsort++;
+    return (x > y) - (x < y);
+}
+
+// Cada estratégia recebe uma cópia descartável da entrada.
+typedef struct {
+    long long comparacoes;  // -1 se não contado
+    long long trocas;       // -1 se não contado
+    int profundidade;       // -1 se não contado
+} Contagem;
+
+// Prepara/lê os contadores de kesimo.c (só existem com KESIMO_ESTATISTICAS).
+static void contagemIniciar(Contagem *c) {
+    c->comparacoes = c->trocas = -1;
+    c->profundidade = -1;
+#ifdef KESIMO_ESTATISTICAS
+    kesimoEstatisticasZerar();
+#endif
+}
+
+static void contagemFinalizar(Contagem *c) {
+#ifdef KESIMO_ESTATISTICAS
+    EstatisticasKesimo e = kesimoEstatisticasLer();
+    c->comparacoes = e.comparacoesInsertion + e.comparacoesParticao + e.comparacoesRede;
+    c->trocas = e.trocas;
+    c->profundidade = e.profundidadeMax;
+#else
+    (void)c;
+#endif
+}
+
+typedef int (*Estrategia)(int v[], int n, int k, Contagem *c);
+
+static int estrategiaKesimo(int v[], int n, int k, Contagem *c) {
+    contagemIniciar(c);
+    int resultado = kesimoMinimo(v, 0, n - 1, k);
+    contagemFinalizar(c);
+    return resultado;
+}
+
+static int estrategiaRapido(int v[], int n, int k, Contagem *c) {
+    contagemIniciar(c);
+    int resultado = kesimoRapido(v, 0, n - 1, k);
+    contagemFinalizar(c);
+    return resultado;
+}
+
+static int estrategiaRede(int v[], int n, int k, Contagem *c) {
+    contagemIniciar(c);
+    int resultado = kesimoRede(v, n, k);
+    contagemFinalizar(c);
+    return resultado;
+}
+
+static int estrategiaAproximado(int v[], int n, int k, Contagem *c) {
+    contagemIniciar(c);
+    int resultado = kesimoAproximado(v, n, k, 0.01, 0.01, 1, 0).valor;
+    contagemFinalizar(c);
+    return resultado;
+}
+
+static int estrategiaOrdenar(int v[], int n, int k, Contagem *c) {
+    contagemIniciar(c);
+    ordenar(v, n);
+    contagemFinalizar(c);
+    return v[k - 1];
+}
+
+static int estrategiaQsort(int v[], int n, int k, Contagem *c) {
+    contagemIniciar(c);
+    comparacoesQsort = 0;
+    qsort(v, n, sizeof(int), compararInt);
+    c->comparacoes = comparacoesQsort;
+    return v[k - 1];
+}
+
+typedef struct {
+    const char *nome;
+    Estrategia executar;
+    int nMax;      // maior n suportado (0 = sem limite)
+    int exata;     // 0 para estratégias aproximadas (não conferimos o valor)
+} DescricaoEstrategia;
+
+static const DescricaoEstrategia estrategias[] = {
+    {"kesimoMinimo", estrategiaKesimo, 0, 1},
+    {"kesimoRapido", estrategiaRapido, 0, 1},
+    {"kesimoRede", estrategiaRede, LIMITE_REDE, 1},
+    {"kesimoAproximado", estrategiaAproximado, 0, 0},
+    {"ordenar", estrategiaOrdenar, 0, 1},
+    {"qsort", estrategiaQsort, 0, 1},
+};
+
+/* ===================== Medição ===================== */
+
+static double agoraNs(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static long picoMemoriaKb(void) {
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+static void imprimirLinha(int json, int *primeira, const char *estrategia, const char *dist,
+                          long n, long k, double nsPorElemento, const Contagem *c, long picoKb) {
+    if (json) {
+        printf("%s\n  {\"estrategia\": \"%s\", \"distribuicao\": \"%s\", \"n\": %ld, \"k\": %ld, "
+               "\"ns_por_elemento\": %.3f, \"comparacoes\": %lld, \"trocas\": %lld, "
+               "\"profundidade\": %d, \"pico_kb\": %ld}",
+               *primeira ? "" : ",", estrategia, dist, n, k, nsPorElemento,
+               c->comparacoes, c->trocas, c->profundidade, picoKb);
+    } else {
+        printf("%s,%s,%ld,%ld,%.3f,%lld,%lld,%d,%ld\n", estrategia, dist, n, k, nsPorElemento,
+               c->comparacoes, c->trocas, c->profundidade, picoKb);
+    }
+    *primeira = 0;
+}
+
+int main(int argc, char *argv[]) {
+    long nMin = 10, nMax = 10000000;
+    int repeticoes = 3, json = 0;
+    unsigned int semente = 12345;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--nmin") && i + 1 < argc) nMin = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--nmax") && i + 1 < argc) nMax = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--reps") && i + 1 < argc) repeticoes = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) semente = (unsigned int)atol(argv[++i]);
+        else if (!strcmp(argv[i], "--json")) json = 1;
+        else {
+            fprintf(stderr, "uso: %s [--nmin N] [--nmax N] [--reps R] [--seed S] [--json]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (nMin < 1 || nMax > INT_MAX || nMin > nMax || repeticoes < 1) {
+        fprintf(stderr, "parametros invalidos\n");
+        return 1;
+    }
+
+    srand(semente);
+    inicializarRedesSelecao();
+
+    int primeira = 1;
+    if (json) printf("[");
+    else printf("estrategia,distribuicao,n,k,ns_por_elemento,comparacoes,trocas,profundidade,pico_kb\n");
+
+    int nDist = sizeof(distribuicoes) / sizeof(distribuicoes[0]);
+    int nEstr = sizeof(estrategias) / sizeof(estrategias[0]);
+
+    for (long nl = nMin; nl <= nMax; nl *= 10) {
+        int n = (int)nl;
+        int *entrada = (int*)malloc((size_t)n * sizeof(int));
+        int *trabalho = (int*)malloc((size_t)n * sizeof(int));
+        if (entrada == NULL || trabalho == NULL) {
+            fprintf(stderr, "sem memoria para n = %d\n", n);
+            free(entrada);
+            free(trabalho);
+            break;
+        }
+
+        for (int d = 0; d < nDist; d++) {
+            distribuicoes[d].gerar(entrada, n);
+
+            // Referência: k nas pontas e no meio
+            int ks[3] = {1, (n + 1) / 2, n};
+            int esperados[3];
+            memcpy(trabalho, entrada, (size_t)n * sizeof(int));
+            qsort(trabalho, n, sizeof(int), compararInt);
+            for (int q = 0; q < 3; q++) esperados[q] = trabalho[ks[q] - 1];
+
+            for (int e = 0; e < nEstr; e++) {
+                if (estrategias[e].nMax && n > estrategias[e].nMax) continue;
+                for (int q = 0; q < 3; q++) {
+                    if (q > 0 && ks[q] == ks[q - 1]) continue;
+                    Contagem c = {-1, -1, -1};
+                    double melhor = 0.0;
+                    for (int rep = 0; rep < repeticoes; rep++) {
+                        memcpy(trabalho, entrada, (size_t)n * sizeof(int));
+                        double t0 = agoraNs();
+                        int resultado = estrategias[e].executar(trabalho, n, ks[q], &c);
+                        double t = agoraNs() - t0;
+                        if (rep == 0 || t < melhor) melhor = t;
+                        if (estrategias[e].exata && resultado != esperados[q])
+                            fprintf(stderr, "ERRO: %s em %s (n=%d, k=%d) devolveu %d, esperado %d\n",
+                                    estrategias[e].nome, distribuicoes[d].nome, n, ks[q],
+                                    resultado, esperados[q]);
+                    }
+                    imprimirLinha(json, &primeira, estrategias[e].nome, distribuicoes[d].nome,
+                                  n, ks[q], melhor / n, &c, picoMemoriaKb());
+                }
+            }
+        }
+
+        free(entrada);
+        free(trabalho);
+    }
+
+    if (json) printf("\n]\n");
+    return 0;
+}
@@ -0,0 +1,334 @@
+#define KESIMO_SEM_MAIN
+#include "kesimo.c"
+#define STRASSEN_SEM_MAIN
+#include "strassen.c"
+
+#include <string.h>
+#include <time.h>
+
+/*
+ * Filtro de mediana 2D sobre matrizes int** (layout de alocarMatriz),
+ * com custo O(1) por pixel em relação ao raio (Perreault & Hébert, 2007).
+ *
+ * Compilar com: gcc -O2 -pthread filtro_mediana.c -o filtro_mediana -lm
+ *
+ * Ideia:
+ * - Os valores são trocados pelos seus postos 0..D-1 (D = valores distintos),
+ *   para que caibam num histograma.
+ * - Cada coluna mantém um histograma das 2r+1 linhas em volta da linha
+ *   atual; descer uma linha custa 1 remoção + 1 inserção por coluna.
+ * - O histograma da janela anda para a direita somando a coluna que entra
+ *   e subtraindo a que sai.
+ * - Histogramas em dois níveis: G faixas "grossas" de G postos cada
+ *   (G ~ sqrt(D)). A janela atualiza só as grossas a cada pixel; a faixa
+ *   fina só é atualizada quando a mediana cai nela (atualização
+ *   preguiçosa), então o custo por pixel é O(G), não O(D).
+ * - Os laços de soma/subtração de histogramas percorrem vetores
+ *   contíguos de uint16 e são vetorizados pelo compilador.
+ * - A imagem é processada em faixas de linhas (uma tarefa paralela cada)
+ *   e, dentro da faixa, em blocos de colunas cujo conjunto de
+ *   histogramas de coluna cabe na cache. O bloco tem ao menos
+ *   COLUNAS_POR_RAIO·(2r+1) colunas e a faixa ao menos max(2r+1, G)
+ *   linhas, para que recomeçar a janela em cada bloco e montar os
+ *   histogramas de coluna não voltem a depender do raio.
+ * Bordas: replica a linha/coluna mais próxima.
+ * Se houver mais de LIMITE_POSTOS valores distintos, os histogramas não
+ * compensam e cada janela é resolvida com kesimoMinimo.
+ */
+
+#define LIMITE_POSTOS 65536
+#define BYTES_BLOCO (512 * 1024)   // alvo para os histogramas de coluna de um bloco
+#define BYTES_MAX_BLOCO (64 << 20) // teto quando o bloco cresce com o raio
+#define COLUNAS_POR_RAIO 4         // largura mínima do bloco, em janelas (2r+1)
+
+typedef unsigned short contagem_t;
+
+typedef struct {
+    int linhas, colunas, raio;
+    int **entrada, **saida;
+    int *postos;         // postos da entrada, linha a linha (linhas*colunas)
+    int *valores;        // valores distintos em ordem (D)
+    int nValores;
+    int G;               // faixas grossas e postos por faixa
+    atomic_int falhou;   // alguma faixa ficou sem memória
+    int linhasPorFaixa;
+} FiltroMediana;
+
+static int limitar(int x, int lo, int hi) {
+    return x < lo ? lo : (x > hi ? hi : x);
+}
+
+static void somarSegmento(contagem_t *destino, const contagem_t *origem, int tam) {
+    for (int i = 0; i < tam; i++) destino[i] += origem[i];
+}
+
+static void subtrairSegmento(contagem_t *destino, const contagem_t *origem, int tam) {
+    for (int i = 0; i < tam; i++) destino[i] -= origem[i];
+}
+
+/* Processa as linhas [y0, y1) usando histogramas. Retorna -1 se faltar memória. */
+static int filtrarFaixaHistograma(const FiltroMediana *f, int y0, int y1) {
+    int W = f->colunas, H = f->linhas, r = f->raio, G = f->G;
+    int binsFinos = G * G;
+    int janela = (2 * r + 1) * (2 * r + 1);
+    int alvo = janela / 2;   // índice 0-based da mediana
+
+    // Largura do bloco de colunas: histogramas de (T + 2r) colunas na cache.
+    // Cada linha de bloco recomeça a janela grossa e a faixa fina, O(r·G);
+    // com T >= COLUNAS_POR_RAIO·(2r+1) isso fica O(G) por pixel, também
+    // quando D é grande e a cache só comportaria poucas colunas.
+    size_t bytesColuna = (size_t)(binsFinos + G) * sizeof(contagem_t);
+    int T = (int)(BYTES_BLOCO / bytesColuna) - 2 * r;
+    if (T < COLUNAS_POR_RAIO * (2 * r + 1)) T = COLUNAS_POR_RAIO * (2 * r + 1);
+    if (T > (int)(BYTES_MAX_BLOCO / bytesColuna) - 2 * r) T = (int)(BYTES_MAX_BLOCO / bytesColuna) - 2 * r;
+    if (T < 8) T = 8;
+    if (T > W) T = W;
+
+    int maxColunas = T + 2 * r;
+    contagem_t *colFina = (contagem_t*)malloc((size_t)maxColunas * binsFinos * sizeof(contagem_t));
+    contagem_t *colGrossa = (contagem_t*)malloc((size_t)maxColunas * G * sizeof(contagem_t));
+    contagem_t *fina = (contagem_t*)malloc((size_t)binsFinos * sizeof(contagem_t));
+    contagem_t *grossa = (contagem_t*)malloc((size_t)G * sizeof(contagem_t));
+    int *ultimo = (int*)malloc((size_t)G * sizeof(int));
+    if (colFina == NULL || colGrossa == NULL || fina == NULL || grossa == NULL || ultimo == NULL) {
+        free(colFina);
+        free(colGrossa);
+        free(fina);
+        free(grossa);
+        free(ultimo);
+        return -1;
+    }
+
+    for (int x0 = 0; x0 < W; x0 += T) {
+        int x1 = x0 + T < W ? x0 + T : W;
+        int cIni = x0 - r > 0 ? x0 - r : 0;               // colunas físicas necessárias
+        int cFim = x1 - 1 + r < W - 1 ? x1 - 1 + r : W - 1;
+        int nc = cFim - cIni + 1;
+
+        // histogramas de coluna para a linha y0
+        memset(colFina, 0, (size_t)nc * binsFinos * sizeof(contagem_t));
+        memset(colGrossa, 0, (size_t)nc * G * sizeof(contagem_t));
+        for (int dy = -r; dy <= r; dy++) {
+            const int *linha = f->postos + (size_t)limitar(y0 + dy, 0, H - 1) * W;
+            for (int c = 0; c < nc; c++) {
+                int p = linha[cIni + c];
+                colFina[(size_t)c * binsFinos + p]++;
+                colGrossa[(size_t)c * G + p / G]++;
+            }
+        }
+
+        for (int y = y0; y < y1; y++) {
+            if (y > y0) {
+                const int *sai = f->postos + (size_t)limitar(y - r - 1, 0, H - 1) * W;
+                const int *entra = f->postos + (size_t)limitar(y + r, 0, H - 1) * W;
+                for (int c = 0; c < nc; c++) {
+                    int ps = sai[cIni + c], pe = entra[cIni + c];
+                    colFina[(size_t)c * binsFinos + ps]--;
+                    colGrossa[(size_t)c * G + ps / G]--;
+                    colFina[(size_t)c * binsFinos + pe]++;
+                    colGrossa[(size_t)c * G + pe / G]++;
+                }
+            }
+
+            // janela na coluna x0: só as grossas; as finas ficam "velhas"
+            memset(grossa, 0, G * sizeof(contagem_t));
+            for (int dx = -r; dx <= r; dx++)
+                somarSegmento(grossa, colGrossa + (size_t)(limitar(x0 + dx, 0, W - 1) - cIni) * G, G);
+            for (int g = 0; g < G; g++) ultimo[g] = INT_MIN;
+
+            for (int x = x0; x < x1; x++) {
+                if (x > x0) {
+                    somarSegmento(grossa, colGrossa + (size_t)(limitar(x + r, 0, W - 1) - cIni) * G, G);
+                    subtrairSegmento(grossa, colGrossa + (size_t)(limitar(x - r - 1, 0, W - 1) - cIni) * G, G);
+                }
+
+                // 1) faixa grossa onde está a mediana
+                int acumulado = 0, g = 0;
+                while (acumulado + grossa[g] <= alvo) acumulado += grossa[g++];
+
+                // 2) atualiza (preguiçosamente) a faixa fina g até a coluna x
+                contagem_t *seg = fina + (size_t)g * G;
+                if (ultimo[g] != INT_MIN && x - ultimo[g] <= 2 * r) {
+                    for (int c = ultimo[g] + 1; c <= x; c++) {
+                        somarSegmento(seg, colFina + (size_t)(limitar(c + r, 0, W - 1) - cIni) * binsFinos + (size_t)g * G, G);
+                        subtrairSegmento(seg, colFina + (size_t)(limitar(c - r - 1, 0, W - 1) - cIni) * binsFinos + (size_t)g * G, G);
+                    }
+                } else {
+                    memset(seg, 0, G * sizeof(contagem_t));
+                    for (int dx = -r; dx <= r; dx++)
+                        somarSegmento(seg, colFina + (size_t)(limitar(x + dx, 0, W - 1) - cIni) * binsFinos + (size_t)g * G, G);
+                }
+                ultimo[g] = x;
+
+                // 3) posto exato dentro da faixa
+                int b = 0;
+                while (acumulado + seg[b] <= alvo) acumulado += seg[b++];
+                f->saida[y][x] = f->valores[g * G + b];
+            }
+        }
+    }
+
+    free(colFina);
+    free(colGrossa);
+    free(fina);
+    free(grossa);
+    free(ultimo);
+    return 0;
+}
+
+/*
+ * Processa as linhas [y0, y1) selecionando cada janela com kesimoMinimo.
+ * Janelas com mais de 5·MEDIANAS_NA_PILHA pixels fazem kesimoMinimo
+ * alocar; se ele devolver INT_MAX sem que essa seja a mediana, faltou
+ * memória. Retorna -1 nesse caso.
+ */
+static int filtrarFaixaDireta(const FiltroMediana *f, int y0, int y1) {
+    int r = f->raio, janela = (2 * r + 1) * (2 * r + 1);
+    int *buffer = (int*)malloc((size_t)janela * sizeof(int));
+    if (buffer == NULL) return -1;
+    for (int y = y0; y < y1; y++) {
+        for (int x = 0; x < f->colunas; x++) {
+            int t = 0;
+            for (int dy = -r; dy <= r; dy++) {
+                const int *linha = f->entrada[limitar(y + dy, 0, f->linhas - 1)];
+                for (int dx = -r; dx <= r; dx++) buffer[t++] = linha[limitar(x + dx, 0, f->colunas - 1)];
+            }
+            int mediana = kesimoMinimo(buffer, 0, janela - 1, janela / 2 + 1);
+            if (mediana == INT_MAX) {
+                int menores = 0;
+                for (int i = 0; i < janela; i++) menores += buffer[i] < INT_MAX;
+                if (menores > janela / 2) {
+                    free(buffer);
+                    return -1;
+                }
+            }
+            f->saida[y][x] = mediana;
+        }
+    }
+    free(buffer);
+    return 0;
+}
+
+static void filtrarFaixa(void *ctx, int faixa) {
+    FiltroMediana *f = (FiltroMediana*)ctx;
+    int y0 = faixa * f->linhasPorFaixa;
+    int y1 = y0 + f->linhasPorFaixa < f->linhas ? y0 + f->linhasPorFaixa : f->linhas;
+    int status = f->postos != NULL ? filtrarFaixaHistograma(f, y0, y1) : filtrarFaixaDireta(f, y0, y1);
+    if (status != 0) atomic_store(&f->falhou, 1);
+}
+
+/*
+ * filtroMediana(linhas, colunas, entrada, saida, raio, nThreads):
+ * - saida[y][x] = mediana da janela (2*raio+1) x (2*raio+1) centrada em (y, x).
+ * - 'entrada' não é alterada; 'saida' deve ser outra matriz do mesmo tamanho.
+ * - 0 <= raio <= 127 (as contagens dos histogramas são de 16 bits).
+ * - Retorna 0 em caso de sucesso e -1 para parâmetros inválidos ou falta
+ *   de memória (nesse caso 'saida' fica incompleta).
+ */
+int filtroMediana(int linhas, int colunas, int **entrada, int **saida, int raio, int nThreads) {
+    if (linhas <= 0 || colunas <= 0 || raio < 0 || raio > 127 || entrada == saida) return -1;
+    if (nThreads < 1) nThreads = 1;
+
+    FiltroMediana f;
+    f.linhas = linhas;
+    f.colunas = colunas;
+    f.raio = raio;
+    f.entrada = entrada;
+    f.saida = saida;
+    atomic_init(&f.falhou, 0);
+
+    // Postos: ordena uma cópia, remove repetidos e busca cada valor.
+    size_t total = (size_t)linhas * colunas;
+    int *valores = (int*)malloc(total * sizeof(int));
+    if (valores == NULL) return -1;
+    for (int y = 0; y < linhas; y++) memcpy(valores + (size_t)y * colunas, entrada[y], colunas * sizeof(int));
+    ordenar(valores, (int)total);
+    int D = 0;
+    for (size_t i = 0; i < total; i++)
+        if (D == 0 || valores[i] != valores[D - 1]) valores[D++] = valores[i];
+    f.valores = valores;
+    f.nValores = D;
+
+    if (D <= LIMITE_POSTOS) {
+        f.G = 1;
+        while (f.G * f.G < D) f.G++;
+        f.postos = (int*)malloc(total * sizeof(int));
+        if (f.postos == NULL) {
+            free(valores);
+            return -1;
+        }
+        for (int y = 0; y < linhas; y++)
+            for (int x = 0; x < colunas; x++)
+                f.postos[(size_t)y * colunas + x] = limiteInferior(valores, 0, D, entrada[y][x]);
+    } else {
+        f.G = 0;
+        f.postos = NULL;
+    }
+
+    // Faixas de linhas: algumas por thread para equilibrar a carga. Com
+    // histogramas, cada faixa tem ao menos max(2r+1, G) linhas para que
+    // montar os histogramas de coluna (O(r + G²) por coluna) saia O(G) por pixel.
+    int nFaixas = nThreads * 4 < linhas ? nThreads * 4 : linhas;
+    f.linhasPorFaixa = (linhas + nFaixas - 1) / nFaixas;
+    if (f.postos != NULL) {
+        int minimo = 2 * raio + 1 > f.G ? 2 * raio + 1 : f.G;
+        if (f.linhasPorFaixa < minimo) f.linhasPorFaixa = minimo < linhas ? minimo : linhas;
+    }
+    nFaixas = (linhas + f.linhasPorFaixa - 1) / f.linhasPorFaixa;
+    executarEmParalelo(nFaixas, nThreads, filtrarFaixa, &f);
+
+    free(f.postos);
+    free(valores);
+    return atomic_load(&f.falhou) ? -1 : 0;
+}
+
+/* ===================== Exemplo mínimo de uso =====================
+ * Outros programas podem reaproveitar o filtro com
+ * #define FILTRO_SEM_MAIN antes de #include "filtro_mediana.c".
+ */
+
+#ifndef FILTRO_SEM_MAIN
+int main() {
+    int n = 6;
+    int **A = alocarMatriz(n);
+    int **M = alocarMatriz(n);
+
+    // Degraus suaves com dois pixels de ruído "sal" (999)
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) A[i][j] = 10 * (i / 2) + j;
+    A[1][1] = 999;
+    A[4][3] = 999;
+
+    filtroMediana(n, n, A, M, 1, 2);
+
+    printf("Entrada:\n");
+    imprimirMatriz(n, A);
+    printf("Mediana 3x3:\n");
+    imprimirMatriz(n, M);   // os 999 desaparecem
+
+    liberarMatriz(n, A);
+    liberarMatriz(n, M);
+
+    // Muitos valores distintos (D ~ 65536) e raio grande: o tempo por
+    // pixel deve ficar próximo do de raio 1.
+    n = 512;
+    A = alocarMatriz(n);
+    M = alocarMatriz(n);
+    srand(1);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) A[i][j] = rand() % 65536;
+    int raios[2] = {1, 30};
+    for (int q = 0; q < 2; q++) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        filtroMediana(n, n, A, M, raios[q], 1);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        printf("%dx%d, D ~ 65536, raio %d: %.2f s\n", n, n, raios[q],
+               (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+    }
+
+    liberarMatriz(n, A);
+    liberarMatriz(n, M);
+    return 0;
+}
+#endif
@@ -0,0 +1,307 @@
+#ifndef FORKJOIN_H
+#define FORKJOIN_H
+
+/*
+ * Runtime fork-join com roubo de tarefas, compartilhado pelos algoritmos
+ * de divisão e conquista do projeto (strassen, kesimoMinimo, ordenar,
+ * executarEmParalelo).
+ *
+ * Uso:
+ *     TarefaFJ t;
+ *     fjCriar(&t, corpo, arg);   // "fork": corpo(arg) pode rodar em outra thread
+ *     ...trabalho da própria chamada...
+ *     fjEsperar(&t);             // "join"
+ * e, na raiz, fjExecutar(nTrabalhadores, raiz, arg).
+ *
+ * - Cada trabalhador tem uma fila dupla (deque) protegida por trava:
+ *   o dono empilha e desempilha pelo fundo (LIFO, bom para a cache);
+ *   quem está ocioso rouba pelo topo (as tarefas mais antigas, que
+ *   em divisão e conquista são as maiores).
+ * - Roubamos a tarefa filha, não a continuação: em C não há como
+ *   suspender o resto da função que chamou fjCriar. Para compensar,
+ *   fjEsperar não fica parado: roda o que ainda estiver na própria fila
+ *   e, se a filha foi roubada, rouba trabalho dos outros até ela terminar.
+ * - Corte sequencial: fora de fjExecutar, ou com a fila cheia
+ *   (FJ_CAPACIDADE_FILA), fjCriar executa a tarefa na hora. Cada
+ *   algoritmo ainda decide, pelo tamanho do subproblema, se vale criar.
+ * - O pool é criado na primeira raiz e cresce se uma raiz pedir mais
+ *   trabalhadores; numa raiz com menos, os excedentes ficam dormindo.
+ *   Raízes de threads externas diferentes rodam uma de cada vez;
+ *   dentro do pool, fjExecutar só executa a raiz (paralelismo aninhado).
+ * - fjMetricas: tarefas criadas, roubos, execuções imediatas e maior
+ *   profundidade de fila observada, somados entre os trabalhadores.
+ * - Cancelamento cooperativo: fjDefinirCancelamento instala uma flag na
+ *   thread; toda tarefa criada dali em diante herda a flag, em qualquer
+ *   thread que a execute. Os algoritmos consultam fjCancelado() na
+ *   entrada de cada chamada recursiva e desistem se ela estiver ligada.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sched.h>
+
+#define FJ_MAX_TRABALHADORES 256
+#define FJ_CAPACIDADE_FILA 1024
+
+typedef struct {
+    void (*corpo)(void *arg);
+    void *arg;
+    const atomic_int *cancelamento;   // herdado de quem criou a tarefa
+    atomic_int pronta;
+} TarefaFJ;
+
+typedef struct {
+    pthread_mutex_t trava;
+    TarefaFJ *itens[FJ_CAPACIDADE_FILA];   // buffer circular
+    long topo, fundo;                      // itens[topo .. fundo-1]
+    // métricas (cada uma só é escrita pelo dono da fila)
+    long long criadas, roubos, imediatas;
+    int profundidadeMax;
+} FilaFJ;
+
+typedef struct {
+    long long tarefasCriadas;    // tarefas empilhadas por fjCriar
+    long long roubos;            // tarefas tiradas da fila de outro trabalhador
+    long long execucoesImediatas;// fjCriar que rodou na hora (fila cheia)
+    int profundidadeMaxFila;     // maior número de tarefas numa fila
+    int trabalhadores;           // tamanho atual do pool (inclui a raiz)
+} MetricasFJ;
+
+static struct {
+    int n;                       // trabalhadores; o 0 é a thread da raiz
+    atomic_int limite;           // trabalhadores liberados para a raiz atual
+    FilaFJ *filas;
+    pthread_t *threads;
+    atomic_int ativa;            // há uma raiz em execução
+    atomic_int encerrar;
+    pthread_mutex_t trava;
+    pthread_cond_t acordar;
+    pthread_mutex_t travaRaiz;
+} fjPool = {0, 0, NULL, NULL, 0, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+            PTHREAD_MUTEX_INITIALIZER};
+
+static _Thread_local int fjId = -1;   // índice do trabalhador, -1 fora do pool
+static _Thread_local const atomic_int *fjCancelamento = NULL;
+
+// Instala a flag de cancelamento da thread atual; retorna a anterior.
+static inline const atomic_int *fjDefinirCancelamento(const atomic_int *flag) {
+    const atomic_int *anterior = fjCancelamento;
+    fjCancelamento = flag;
+    return anterior;
+}
+
+// 1 se o trabalho em execução nesta thread foi cancelado.
+static inline int fjCancelado(void) {
+    return fjCancelamento != NULL && atomic_load_explicit(fjCancelamento, memory_order_relaxed);
+}
+
+static inline void fjRodar(TarefaFJ *t) {
+    const atomic_int *anterior = fjDefinirCancelamento(t->cancelamento);
+    t->corpo(t->arg);
+    fjDefinirCancelamento(anterior);
+    atomic_store_explicit(&t->pronta, 1, memory_order_release);
+}
+
+static inline int fjTerminou(TarefaFJ *t) {
+    return atomic_load_explicit(&t->pronta, memory_order_acquire);
+}
+
+// Tira uma tarefa do topo da fila de outro trabalhador (NULL se não achar).
+static inline TarefaFJ *fjRoubar(unsigned int *semente) {
+    int n = atomic_load(&fjPool.limite);
+    if (n <= 1) return NULL;
+    *semente = *semente * 1103515245u + 12345u;
+    int inicio = (int)((*semente >> 16) % (unsigned int)n);
+    for (int d = 0; d < n; d++) {
+        int v = (inicio + d) % n;
+        if (v == fjId) continue;
+        FilaFJ *f = &fjPool.filas[v];
+        if (pthread_mutex_trylock(&f->trava) != 0) continue;   // ocupada: tenta a próxima
+        TarefaFJ *t = NULL;
+        if (f->fundo > f->topo) t = f->itens[f->topo++ % FJ_CAPACIDADE_FILA];
+        pthread_mutex_unlock(&f->trava);
+        if (t != NULL) {
+            fjPool.filas[fjId].roubos++;
+            return t;
+        }
+    }
+    return NULL;
+}
+
+static void *fjTrabalhador(void *arg) {
+    fjId = (int)(intptr_t)arg;
+    unsigned int semente = (unsigned int)fjId * 2654435761u;
+    while (!atomic_load(&fjPool.encerrar)) {
+        if (!atomic_load(&fjPool.ativa) || fjId >= atomic_load(&fjPool.limite)) {
+            pthread_mutex_lock(&fjPool.trava);
+            while ((!atomic_load(&fjPool.ativa) || fjId >= atomic_load(&fjPool.limite)) && !atomic_load(&fjPool.encerrar))
+                pthread_cond_wait(&fjPool.acordar, &fjPool.trava);
+            pthread_mutex_unlock(&fjPool.trava);
+            continue;
+        }
+        TarefaFJ *t = fjRoubar(&semente);
+        if (t != NULL) fjRodar(t);
+        else sched_yield();
+    }
+    return NULL;
+}
+
+/*
+ * fjEncerrar: para e libera o pool (as métricas se perdem).
+ * Só pode ser chamada sem raiz em execução.
+ */
+static inline void fjEncerrar(void) {
+    if (fjPool.n == 0) return;
+    pthread_mutex_lock(&fjPool.trava);
+    atomic_store(&fjPool.encerrar, 1);
+    pthread_cond_broadcast(&fjPool.acordar);
+    pthread_mutex_unlock(&fjPool.trava);
+    for (int i = 1; i < fjPool.n; i++) pthread_join(fjPool.threads[i], NULL);
+    for (int i = 0; i < fjPool.n; i++) pthread_mutex_destroy(&fjPool.filas[i].trava);
+    free(fjPool.filas);
+    free(fjPool.threads);
+    fjPool.filas = NULL;
+    fjPool.threads = NULL;
+    fjPool.n = 0;
+    atomic_store(&fjPool.encerrar, 0);
+}
+
+// Garante um pool com pelo menos n trabalhadores (chamada com travaRaiz).
+// Retorna -1, com o pool vazio, se faltar memória para as filas.
+static inline int fjGarantir(int n) {
+    if (fjPool.n >= n) return 0;
+    fjEncerrar();
+    fjPool.filas = (FilaFJ*)calloc(n, sizeof(FilaFJ));
+    fjPool.threads = (pthread_t*)calloc(n, sizeof(pthread_t));
+    if (fjPool.filas == NULL || fjPool.threads == NULL) {
+        free(fjPool.filas);
+        free(fjPool.threads);
+        fjPool.filas = NULL;
+        fjPool.threads = NULL;
+        return -1;
+    }
+    for (int i = 0; i < n; i++) pthread_mutex_init(&fjPool.filas[i].trava, NULL);
+    fjPool.n = 1;
+    for (int i = 1; i < n; i++)
+        if (pthread_create(&fjPool.threads[i], NULL, fjTrabalhador, (void*)(intptr_t)i) == 0) fjPool.n++;
+        else break;
+    return 0;
+}
+
+/*
+ * fjCriar(t, corpo, arg): registra corpo(arg) como tarefa filha.
+ * 't' (e o que 'arg' aponta) deve continuar vivo até fjEsperar(t).
+ */
+static inline void fjCriar(TarefaFJ *t, void (*corpo)(void *arg), void *arg) {
+    t->corpo = corpo;
+    t->arg = arg;
+    t->cancelamento = fjCancelamento;
+    atomic_store_explicit(&t->pronta, 0, memory_order_relaxed);
+    if (fjId < 0) {
+        fjRodar(t);
+        return;
+    }
+
+    FilaFJ *f = &fjPool.filas[fjId];
+    pthread_mutex_lock(&f->trava);
+    int tam = (int)(f->fundo - f->topo);
+    if (tam < FJ_CAPACIDADE_FILA) {
+        f->itens[f->fundo++ % FJ_CAPACIDADE_FILA] = t;
+        f->criadas++;
+        if (tam + 1 > f->profundidadeMax) f->profundidadeMax = tam + 1;
+    }
+    pthread_mutex_unlock(&f->trava);
+
+    if (tam >= FJ_CAPACIDADE_FILA) {
+        f->imediatas++;
+        fjRodar(t);
+    }
+}
+
+// fjEsperar(t): retorna quando a tarefa t terminou, trabalhando enquanto isso.
+static inline void fjEsperar(TarefaFJ *t) {
+    if (fjTerminou(t) || fjId < 0) return;
+
+    // 1) O que ainda está na nossa fila (t inclusive, se ninguém roubou)
+    FilaFJ *f = &fjPool.filas[fjId];
+    while (!fjTerminou(t)) {
+        TarefaFJ *proxima = NULL;
+        pthread_mutex_lock(&f->trava);
+        if (f->fundo > f->topo) proxima = f->itens[--f->fundo % FJ_CAPACIDADE_FILA];
+        pthread_mutex_unlock(&f->trava);
+        if (proxima == NULL) break;
+        fjRodar(proxima);
+    }
+
+    // 2) t foi roubada: ajuda os outros até ela terminar
+    unsigned int semente = (unsigned int)(uintptr_t)t;
+    while (!fjTerminou(t)) {
+        TarefaFJ *outra = fjRoubar(&semente);
+        if (outra != NULL) fjRodar(outra);
+        else sched_yield();
+    }
+}
+
+/*
+ * fjExecutar(nTrabalhadores, corpo, arg): roda corpo(arg) como raiz,
+ * com até nTrabalhadores threads (a que chamou é uma delas) roubando as
+ * tarefas criadas lá dentro. Retorna quando corpo retorna; toda tarefa
+ * criada deve ter sido esperada antes disso. Sem memória para o pool,
+ * corpo roda só na thread que chamou (fjCriar executa na hora).
+ */
+static inline void fjExecutar(int nTrabalhadores, void (*corpo)(void *arg), void *arg) {
+    if (fjId >= 0 || nTrabalhadores <= 1) {
+        corpo(arg);
+        return;
+    }
+    if (nTrabalhadores > FJ_MAX_TRABALHADORES) nTrabalhadores = FJ_MAX_TRABALHADORES;
+
+    pthread_mutex_lock(&fjPool.travaRaiz);
+    if (fjGarantir(nTrabalhadores) != 0) {
+        pthread_mutex_unlock(&fjPool.travaRaiz);
+        corpo(arg);
+        return;
+    }
+    pthread_mutex_lock(&fjPool.trava);
+    atomic_store(&fjPool.limite, nTrabalhadores < fjPool.n ? nTrabalhadores : fjPool.n);
+    atomic_store(&fjPool.ativa, 1);
+    pthread_cond_broadcast(&fjPool.acordar);
+    pthread_mutex_unlock(&fjPool.trava);
+
+    fjId = 0;
+    corpo(arg);
+    fjId = -1;
+
+    atomic_store(&fjPool.ativa, 0);
+    pthread_mutex_unlock(&fjPool.travaRaiz);
+}
+
+// Métricas acumuladas desde a criação do pool (ou do último fjZerarMetricas).
+// Como fjEncerrar, só pode ser chamada fora de fjExecutar.
+static inline MetricasFJ fjMetricas(void) {
+    MetricasFJ m = {0, 0, 0, 0, 0};
+    pthread_mutex_lock(&fjPool.travaRaiz);
+    m.trabalhadores = fjPool.n;
+    for (int i = 0; i < fjPool.n; i++) {
+        m.tarefasCriadas += fjPool.filas[i].criadas;
+        m.roubos += fjPool.filas[i].roubos;
+        m.execucoesImediatas += fjPool.filas[i].imediatas;
+        if (fjPool.filas[i].profundidadeMax > m.profundidadeMaxFila)
+            m.profundidadeMaxFila = fjPool.filas[i].profundidadeMax;
+    }
+    pthread_mutex_unlock(&fjPool.travaRaiz);
+    return m;
+}
+
+static inline void fjZerarMetricas(void) {
+    pthread_mutex_lock(&fjPool.travaRaiz);
+    for (int i = 0; i < fjPool.n; i++) {
+        fjPool.filas[i].criadas = fjPool.filas[i].roubos = fjPool.filas[i].imediatas = 0;
+        fjPool.filas[i].profundidadeMax = 0;
+    }
+    pthread_mutex_unlock(&fjPool.travaRaiz);
+}
+
+#endif
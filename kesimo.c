@@ -1,6 +1,104 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "trace.h"
+#include "forkjoin.h"
+
+/*
+ * Compilar com: gcc -O2 -pthread kesimo.c -o kesimo -lm
+ * (com -DUSAR_TRACE a demonstração grava trace_kesimo.json; ver trace.h)
+ */
+
+/* =========================
+   Instrumentação (opcional)
+   =========================
+   Compilando com -DKESIMO_ESTATISTICAS, as funções de seleção contam
+   comparações, trocas, profundidade de recursão e, por nível, quantos
+   elementos entraram e quão longe da mediana o pivô caiu. Sem a flag,
+   as macros EST_* somem e o código gerado é o mesmo de antes.
+   Os contadores são por thread; zere antes de cada chamada medida.
+*/
+#ifdef KESIMO_ESTATISTICAS
+
+#define EST_MAX_NIVEIS 64
+
+typedef struct {
+    long long comparacoesInsertion;  // comparações feitas por insertionSort
+    long long comparacoesParticao;   // comparações dos particionamentos
+    long long comparacoesRede;       // comparadores aplicados pelas redes
+    long long trocas;                // trocas de elementos
+    int profundidadeMax;             // maior nível de recursão de kesimoMinimo
+    long long chamadasPorNivel[EST_MAX_NIVEIS];
+    long long elementosPorNivel[EST_MAX_NIVEIS];  // soma dos n que entraram no nível
+    double desvioPivoPorNivel[EST_MAX_NIVEIS];    // soma de |posto do pivô - meio| / n
+    double desvioPivoMax[EST_MAX_NIVEIS];
+} EstatisticasKesimo;
+
+static _Thread_local EstatisticasKesimo estatisticas;
+static _Thread_local int estNivel;
+
+#define EST_CONTAR(campo, qtd) (estatisticas.campo += (qtd))
+#define EST_ENTRAR(n) estEntrar(n)
+#define EST_SAIR() (estNivel--)
+#define EST_PIVO(n, ini, fim) estPivo(n, ini, fim)
+
+static void estEntrar(int n) {
+    int nivel = estNivel++;
+    if (estNivel > estatisticas.profundidadeMax) estatisticas.profundidadeMax = estNivel;
+    if (nivel >= EST_MAX_NIVEIS) nivel = EST_MAX_NIVEIS - 1;
+    estatisticas.chamadasPorNivel[nivel]++;
+    estatisticas.elementosPorNivel[nivel] += n;
+}
+
+// O pivô ocupa os postos [ini..fim] (0-based, relativos à fatia de tamanho n).
+static void estPivo(int n, int ini, int fim) {
+    int meio = (n - 1) / 2;
+    int dist = meio < ini ? ini - meio : (meio > fim ? meio - fim : 0);
+    double desvio = (double)dist / n;
+    int nivel = estNivel - 1 < EST_MAX_NIVEIS ? estNivel - 1 : EST_MAX_NIVEIS - 1;
+    estatisticas.desvioPivoPorNivel[nivel] += desvio;
+    if (desvio > estatisticas.desvioPivoMax[nivel]) estatisticas.desvioPivoMax[nivel] = desvio;
+}
+
+// Zera os contadores da thread atual.
+void kesimoEstatisticasZerar(void) {
+    EstatisticasKesimo zero = {0};
+    estatisticas = zero;
+    estNivel = 0;
+}
+
+// Cópia dos contadores da thread atual.
+EstatisticasKesimo kesimoEstatisticasLer(void) {
+    return estatisticas;
+}
+
+// Escreve as estatísticas como um objeto JSON (níveis vazios são omitidos).
+void kesimoEstatisticasJSON(FILE *f, const EstatisticasKesimo *e) {
+    fprintf(f, "{\"comparacoes_insertion\": %lld, \"comparacoes_particao\": %lld, "
+               "\"comparacoes_rede\": %lld, \"trocas\": %lld, \"profundidade_max\": %d, \"niveis\": [",
+            e->comparacoesInsertion, e->comparacoesParticao, e->comparacoesRede,
+            e->trocas, e->profundidadeMax);
+    for (int i = 0; i < EST_MAX_NIVEIS && e->chamadasPorNivel[i] > 0; i++) {
+        fprintf(f, "%s{\"nivel\": %d, \"chamadas\": %lld, \"elementos\": %lld, "
+                   "\"desvio_pivo_medio\": %.4f, \"desvio_pivo_max\": %.4f}",
+                i ? ", " : "", i, e->chamadasPorNivel[i], e->elementosPorNivel[i],
+                e->desvioPivoPorNivel[i] / e->chamadasPorNivel[i], e->desvioPivoMax[i]);
+    }
+    fprintf(f, "]}");
+}
+
+#else
+
+#define EST_CONTAR(campo, qtd) ((void)0)
+#define EST_ENTRAR(n) ((void)0)
+#define EST_SAIR() ((void)0)
+#define EST_PIVO(n, ini, fim) ((void)0)
+
+#endif
 
 /* =========================
    Utilitários básicos
@@ -8,6 +106,7 @@
 
 // Troca os valores apontados por a e b
 void trocar(int *a, int *b) {
+    EST_CONTAR(trocas, 1);
     int temp = *a;
     *a = *b;
     *b = temp;
@@ -27,6 +126,7 @@ void insertionSort(int arr[], int n) {
             arr[j + 1] = arr[j];
             j--;
         }
+        EST_CONTAR(comparacoesInsertion, (i - 1 - j) + (j >= 0));
         arr[j + 1] = chave;
     }
 }
@@ -45,9 +145,11 @@ int particionar(int arr[], int l, int r, int pivo) {
     for (i = l; i <= r; i++) {
         if (arr[i] == pivo) break;  // para na primeira ocorrência
     }
+    EST_CONTAR(comparacoesParticao, i - l + 1);
     trocar(&arr[i], &arr[r]);       // pivô fica em arr[r]
 
     // 2) particiona usando Lomuto com comparação <=
+    EST_CONTAR(comparacoesParticao, r - l);
     i = l;
     for (int j = l; j <= r - 1; j++) {
         if (arr[j] <= pivo) {
@@ -60,6 +162,217 @@ int particionar(int arr[], int l, int r, int pivo) {
     return i; // índice final do pivô
 }
 
+/*
+ * particionarTresVias (bandeira holandesa): reorganiza arr[l..r] em
+ *   [l..*ini-1] < pivo,  [*ini..*fim] == pivo,  [*fim+1..r] > pivo.
+ * 'pivo' é um VALOR; se ele não existir no intervalo, *ini = *fim + 1.
+ */
+void particionarTresVias(int arr[], int l, int r, int pivo, int *ini, int *fim) {
+    int lt = l, i = l, gt = r;
+    while (i <= gt) {
+        EST_CONTAR(comparacoesParticao, 1 + (arr[i] >= pivo));
+        if (arr[i] < pivo) trocar(&arr[lt++], &arr[i++]);
+        else if (arr[i] > pivo) trocar(&arr[i], &arr[gt--]);
+        else i++;
+    }
+    *ini = lt;
+    *fim = gt;
+}
+
+/* =========================
+   Redes de seleção (n pequeno)
+   =========================
+   Para n <= LIMITE_REDE, a recursão, o VLA e o particionar custam mais
+   que o próprio trabalho. Usamos redes de comparadores: uma sequência
+   FIXA de pares (a, b) em que cada passo faz v[a] = min, v[b] = max,
+   sem desvios (o compilador gera cmov/min/max).
+
+   Como geramos as redes:
+   - Para cada n, a rede de ordenação de Batcher (odd-even mergesort).
+   - Para cada (n, k), podamos essa rede de trás para frente, mantendo
+     só os comparadores que influenciam a saída na posição k-1. O que
+     sobra é uma rede de SELEÇÃO do k-ésimo menor.
+   As redes ficam numa tabela criada uma única vez (na primeira chamada,
+   ou explicitamente com inicializarRedesSelecao antes de usar threads).
+*/
+
+#define LIMITE_REDE 32
+
+typedef struct {
+    unsigned char a, b;   // fios comparados (a < b)
+} Comparador;
+
+static Comparador *redesPool = NULL;                     // todos os comparadores
+static int redesInicio[LIMITE_REDE + 1][LIMITE_REDE + 1]; // [n][k]; k = 0 é a ordenação completa
+static int redesTam[LIMITE_REDE + 1][LIMITE_REDE + 1];
+
+// Gera a rede de Batcher para n fios (n qualquer). Retorna o nº de comparadores.
+static int gerarRedeBatcher(int n, Comparador saida[]) {
+    int c = 0;
+    for (int p = 1; p < n; p <<= 1) {
+        for (int k = p; k >= 1; k >>= 1) {
+            for (int j = k % p; j + k < n; j += 2 * k) {
+                for (int i = 0; i < k && i + j + k < n; i++) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        saida[c].a = (unsigned char)(i + j);
+                        saida[c].b = (unsigned char)(i + j + k);
+                        c++;
+                    }
+                }
+            }
+        }
+    }
+    return c;
+}
+
+// Poda 'rede' mantendo só o que afeta a posição 'alvo'. Retorna o novo tamanho.
+static int podarRede(const Comparador rede[], int m, int alvo, Comparador saida[]) {
+    unsigned char relevante[LIMITE_REDE] = {0};
+    unsigned char manter[LIMITE_REDE * LIMITE_REDE];
+    relevante[alvo] = 1;
+    for (int c = m - 1; c >= 0; c--) {
+        manter[c] = relevante[rede[c].a] || relevante[rede[c].b];
+        if (manter[c]) relevante[rede[c].a] = relevante[rede[c].b] = 1;
+    }
+    int t = 0;
+    for (int c = 0; c < m; c++)
+        if (manter[c]) saida[t++] = rede[c];
+    return t;
+}
+
+static pthread_once_t redesUmaVez = PTHREAD_ONCE_INIT;
+
+static void montarRedesSelecao(void) {
+    Comparador completa[LIMITE_REDE * LIMITE_REDE];
+    int capacidade = 0;
+    for (int n = 1; n <= LIMITE_REDE; n++)
+        capacidade += (n + 1) * gerarRedeBatcher(n, completa);
+
+    Comparador *pool = (Comparador*)malloc((capacidade + 1) * sizeof(Comparador));
+    if (pool == NULL) {
+        fprintf(stderr, "kesimo: sem memoria para as redes de selecao\n");
+        abort();
+    }
+    int usado = 0;
+    for (int n = 1; n <= LIMITE_REDE; n++) {
+        int m = gerarRedeBatcher(n, completa);
+        redesInicio[n][0] = usado;
+        redesTam[n][0] = m;
+        for (int c = 0; c < m; c++) pool[usado++] = completa[c];
+        for (int k = 1; k <= n; k++) {
+            redesInicio[n][k] = usado;
+            redesTam[n][k] = podarRede(completa, m, k - 1, pool + usado);
+            usado += redesTam[n][k];
+        }
+    }
+    redesPool = pool;
+}
+
+/*
+ * inicializarRedesSelecao: monta a tabela de redes para todo n <= LIMITE_REDE.
+ * É chamada automaticamente na primeira seleção pequena; pthread_once
+ * garante uma única montagem mesmo com várias threads chegando juntas.
+ */
+void inicializarRedesSelecao(void) {
+    pthread_once(&redesUmaVez, montarRedesSelecao);
+}
+
+// Aplica a rede sobre v: cada comparador é um min/max sem desvio.
+static void aplicarRede(int v[], const Comparador rede[], int m) {
+    EST_CONTAR(comparacoesRede, m);
+    for (int c = 0; c < m; c++) {
+        int x = v[rede[c].a], y = v[rede[c].b];
+        v[rede[c].a] = x < y ? x : y;
+        v[rede[c].b] = x < y ? y : x;
+    }
+}
+
+/*
+ * kesimoRede(arr, n, k):
+ * - k-ésimo menor (1-based) de arr[0..n-1] para 1 <= n <= LIMITE_REDE.
+ * - Reorganiza arr; só a posição k-1 tem garantia de estar no lugar.
+ */
+int kesimoRede(int arr[], int n, int k) {
+    if (n <= 0 || n > LIMITE_REDE || k <= 0 || k > n) return INT_MAX;
+    inicializarRedesSelecao();
+    aplicarRede(arr, redesPool + redesInicio[n][k], redesTam[n][k]);
+    return arr[k - 1];
+}
+
+/*
+ * kesimoRedeLote(dados, n, k, nArrays, saida):
+ * - Seleciona o k-ésimo menor de MUITOS vetores independentes de tamanho n.
+ * - Layout "transposto": o elemento w do vetor j está em dados[w * nArrays + j].
+ *   Assim cada comparador vira um laço min/max sobre vetores vizinhos,
+ *   que o compilador vetoriza (SIMD atravessa os vetores, não o vetor).
+ * - saida[j] recebe o resultado do vetor j. Não altera 'dados'.
+ */
+#define LOTE_REDE 64
+
+/*
+ * Aplica a rede às LOTE_REDE colunas de um bloco transposto. A largura
+ * é fixa para o laço interno não ter resto (colunas sobrando são lixo
+ * inofensivo). O gcc só vetoriza esse min/max com -O3 ou -ftree-vectorize
+ * completo; em -O2 o lote fica praticamente empatado com kesimoRede.
+ */
+static void aplicarRedeBloco(int bloco[][LOTE_REDE], const Comparador rede[], int m) {
+    for (int c = 0; c < m; c++) {
+        int *restrict va = bloco[rede[c].a], *restrict vb = bloco[rede[c].b];
+        for (int j = 0; j < LOTE_REDE; j++) {
+            int x = va[j], y = vb[j];
+            va[j] = x < y ? x : y;
+            vb[j] = x < y ? y : x;
+        }
+    }
+}
+
+void kesimoRedeLote(const int dados[], int n, int k, int nArrays, int saida[]) {
+    if (n <= 0 || n > LIMITE_REDE || k <= 0 || k > n) return;
+    inicializarRedesSelecao();
+    const Comparador *rede = redesPool + redesInicio[n][k];
+    int m = redesTam[n][k];
+
+    int bloco[LIMITE_REDE][LOTE_REDE] = {{0}};
+    for (int base = 0; base < nArrays; base += LOTE_REDE) {
+        int largura = nArrays - base < LOTE_REDE ? nArrays - base : LOTE_REDE;
+        for (int w = 0; w < n; w++)
+            for (int j = 0; j < largura; j++) bloco[w][j] = dados[w * nArrays + base + j];
+
+        aplicarRedeBloco(bloco, rede, m);
+
+        for (int j = 0; j < largura; j++) saida[base + j] = bloco[k - 1][j];
+    }
+}
+
+#define CORTE_MEDIANAS_PARALELO (1 << 16)   // elementos por tarefa de medianas
+#define MEDIANAS_NA_PILHA 4096              // acima disso o vetor de medianas vai para o heap
+
+typedef struct {
+    int *arr;
+    int64_t l;
+    int64_t g0, g1;     // grupos de 5 [g0, g1) a partir de arr[l]
+    int *medianas;
+} GruposMedianas;
+
+// Ordena cada grupo de 5 e guarda sua mediana; divide em tarefas se for grande.
+static void medianasDosGrupos(void *arg) {
+    GruposMedianas *g = (GruposMedianas*)arg;
+    if ((g->g1 - g->g0) * 5 >= 2 * CORTE_MEDIANAS_PARALELO) {
+        int64_t meio = g->g0 + (g->g1 - g->g0) / 2;
+        GruposMedianas esquerda = {g->arr, g->l, g->g0, meio, g->medianas};
+        GruposMedianas direita = {g->arr, g->l, meio, g->g1, g->medianas};
+        TarefaFJ t;
+        fjCriar(&t, medianasDosGrupos, &direita);
+        medianasDosGrupos(&esquerda);
+        fjEsperar(&t);
+        return;
+    }
+    for (int64_t i = g->g0; i < g->g1; i++) {
+        insertionSort(g->arr + g->l + i * 5, 5);
+        g->medianas[i] = g->arr[g->l + i * 5 + 2]; // posição 2 (0-based) é a mediana do grupo de 5
+    }
+}
+
 /* =========================
    Seleção determinística:
    k-ésimo menor (1-based)
@@ -67,6 +380,8 @@ int particionar(int arr[], int l, int r, int pivo) {
    kesimoMinimo(arr, l, r, k):
    - Encontra o k-ésimo menor em arr[l..r], com k iniciando em 1.
    - Usa "mediana das medianas" como pivô => O(n) no pior caso.
+   - Subarrays com até LIMITE_REDE elementos vão direto para kesimoRede.
+   - Se o trabalho for cancelado (fjCancelado), retorna INT_MAX.
 */
 int kesimoMinimo(int arr[], int l, int r, int k) {
     // Verifica se k está dentro do número de elementos do subarray atual
@@ -74,19 +389,38 @@ int kesimoMinimo(int arr[], int l, int r, int k) {
 
         int n = r - l + 1; // quantidade de elementos em arr[l..r]
 
+        // Casos pequenos: rede de seleção, sem VLA nem recursão
+        if (n <= LIMITE_REDE)
+            return kesimoRede(arr + l, n, k);
+
+        // Trabalho cancelado (ver forkjoin.h): desiste sem terminar
+        if (fjCancelado()) return INT_MAX;
+
+        EST_ENTRAR(n);
+        TRACE_INICIO("kesimoMinimo", n);
+
         /* ===== 1) DIVIDIR EM GRUPOS DE 5 E PEGAR MEDIANAS =====
            - Para cada grupo de até 5 elementos:
              a) ordena o grupinho com insertion sort
              b) pega a mediana daquele grupinho
            - Armazena todas as medianas no vetor 'medians'.
         */
-        int i; 
-        int medians[(n + 4) / 5]; // quantidade de grupos = ceil(n/5)
-        // grupos "cheios" de 5
-        for (i = 0; i < n / 5; i++) {
-            insertionSort(arr + l + i * 5, 5);
-            medians[i] = arr[l + i * 5 + 2]; // posição 2 (0-based) é a mediana do grupo de 5
+        TRACE_INICIO("medianas", n);
+        int i;
+        int g = n / 5 + (n % 5 != 0); // quantidade de grupos = ceil(n/5), sem estourar em n + 4
+        // Até MEDIANAS_NA_PILHA medianas ficam na pilha; mais que isso, no heap
+        int naPilha[g <= MEDIANAS_NA_PILHA ? g : 1];
+        int *medians = g <= MEDIANAS_NA_PILHA ? naPilha : (int*)malloc((size_t)g * sizeof(int));
+        if (medians == NULL) {
+            TRACE_FIM("medianas", n);
+            TRACE_FIM("kesimoMinimo", n);
+            EST_SAIR();
+            return INT_MAX;
         }
+        // grupos "cheios" de 5 (em tarefas fork-join quando n é grande)
+        GruposMedianas grupos = {arr, l, 0, n / 5, medians};
+        medianasDosGrupos(&grupos);
+        i = n / 5;
         // último grupo (se sobrar < 5 elementos)
         if (i * 5 < n) {
             int resto = n % 5;                     // tamanho do grupo final (1..4)
@@ -94,6 +428,7 @@ int kesimoMinimo(int arr[], int l, int r, int k) {
             medians[i] = arr[l + i * 5 + resto / 2]; // mediana do grupo menor
             i++; // total de medianas
         }
+        TRACE_FIM("medianas", n);
         
         /* ===== 2) CONQUISTAR: MEDIANA DAS MEDIANAS =====
            - Se só existe uma mediana, ela é o pivô.
@@ -108,52 +443,2092 @@ int kesimoMinimo(int arr[], int l, int r, int k) {
         } else {
             medOfMed = kesimoMinimo(medians, 0, i - 1, (i + 1) / 2);
         }
+        if (medians != naPilha) free(medians);
 
         /* ===== 3) PARTICIONAR EM TORNO DO PIVÔ =====
-           - Rearranja arr[l..r] usando 'medOfMed' como pivô
-           - 'pos' é a posição final do pivô no array particionado
+           - Rearranja arr[l..r] em três faixas: < medOfMed, == medOfMed, > medOfMed
+           - [ini..fim] é a faixa dos iguais ao pivô (nunca vazia)
+           - Com o Lomuto (<=) de 'particionar', valores repetidos iam
+             sempre para a esquerda e a recursão encolhia 1 elemento
+             por nível (O(n^2) com todos iguais); as três vias evitam isso.
         */
-        int pos = particionar(arr, l, r, medOfMed);
+        int ini, fim;
+        TRACE_INICIO("particionar", n);
+        particionarTresVias(arr, l, r, medOfMed, &ini, &fim);
+        TRACE_FIM("particionar", n);
+        EST_PIVO(n, ini - l, fim - l);
 
         /* ===== 4) DECIDIR O LADO =====
-           - Se pos-l == k-1, o pivô é exatamente o k-ésimo menor (1-based).
-           - Se pos-l > k-1: o k-ésimo está à ESQUERDA.
+           - Se k-1 cai em [ini-l..fim-l], o pivô é o k-ésimo menor (1-based).
+           - Se k-1 < ini-l: o k-ésimo está à ESQUERDA.
            - Senão: está à DIREITA; ajusta k para o subarray direito.
         */
-        if (pos - l == k - 1)
-            return arr[pos];
-        if (pos - l > k - 1)
-            return kesimoMinimo(arr, l, pos - 1, k);
-        return kesimoMinimo(arr, pos + 1, r, k - (pos - l) - 1);
+        int resultado;
+        if (k - 1 >= ini - l && k - 1 <= fim - l)
+            resultado = medOfMed;
+        else if (k - 1 < ini - l)
+            resultado = kesimoMinimo(arr, l, ini - 1, k);
+        else
+            resultado = kesimoMinimo(arr, fim + 1, r, k - (fim - l) - 1);
+
+        TRACE_FIM("kesimoMinimo", n);
+        EST_SAIR();
+        return resultado;
     }
 
     // k inválido para o intervalo atual
     return INT_MAX;
 }
 
+typedef struct {
+    int *arr;
+    int l, r, k;
+    int resultado;
+} SelecaoParalela;
+
+static void kesimoRaiz(void *arg) {
+    SelecaoParalela *s = (SelecaoParalela*)arg;
+    s->resultado = kesimoMinimo(s->arr, s->l, s->r, s->k);
+}
+
+/*
+ * kesimoParalelo(arr, l, r, k, nThreads): kesimoMinimo com o passo das
+ * medianas dividido entre até nThreads threads do runtime fork-join.
+ */
+int kesimoParalelo(int arr[], int l, int r, int k, int nThreads) {
+    SelecaoParalela s = {arr, l, r, k, INT_MAX};
+    inicializarRedesSelecao();
+    fjExecutar(nThreads, kesimoRaiz, &s);
+    return s.resultado;
+}
+
 /* =========================
-   Demonstração de uso
-   ========================= */
-int main() {
-    int D[] = {25, 21, 98, 100, 76, 22, 43, 60, 89, 42};
-    int n = sizeof(D) / sizeof(D[0]);
-    int k = 5; // queremos o 5º menor (k é 1-based)
+   Índices de 64 bits
+   =========================
+   kesimoMinimo usa int (até 2^31 - 1 elementos). kesimoMinimo64 aceita
+   intervalos maiores: enquanto o intervalo tiver mais de
+   LIMITE_INDICE_ESTREITO elementos, faz um passo da mediana das medianas
+   com índices int64_t (medianas no heap); assim que ele cabe, segue por
+   kesimoMinimo sobre arr + l, com índices int. Entradas pequenas não
+   pagam nada pelos índices largos.
+*/
 
-    printf("Array original: ");
-    for(int i = 0; i < n; i++) printf("%d ", D[i]);
-    printf("\n");
+#define LIMITE_INDICE_ESTREITO INT_MAX
 
-    // Para referência, array ordenado seria:
-    // 21, 22, 25, 42, 43, 60, 76, 89, 98, 100
-    // O 5º menor é 43.
+// particionarTresVias com índices de 64 bits.
+void particionarTresVias64(int arr[], int64_t l, int64_t r, int pivo, int64_t *ini, int64_t *fim) {
+    int64_t lt = l, i = l, gt = r;
+    while (i <= gt) {
+        if (arr[i] < pivo) trocar(&arr[lt++], &arr[i++]);
+        else if (arr[i] > pivo) trocar(&arr[i], &arr[gt--]);
+        else i++;
+    }
+    *ini = lt;
+    *fim = gt;
+}
 
-    int resultado = kesimoMinimo(D, 0, n - 1, k);
+/*
+ * kesimoMinimo64(arr, l, r, k): como kesimoMinimo, com l, r e k de 64 bits.
+ * - Retorna INT_MAX para k inválido, cancelamento ou falta de memória.
+ */
+int kesimoMinimo64(int arr[], int64_t l, int64_t r, int64_t k) {
+    while (k > 0 && k <= r - l + 1) {
+        int64_t n = r - l + 1;
+        if (n <= LIMITE_INDICE_ESTREITO) return kesimoMinimo(arr + l, 0, (int)(n - 1), (int)k);
 
-    if (resultado != INT_MAX) {
-        printf("O %d-esimo menor elemento e: %d\n", k, resultado);
-    } else {
-        printf("k e invalido.\n");
+        if (fjCancelado()) return INT_MAX;
+
+        int64_t cheios = n / 5, g = cheios + (n % 5 != 0);
+        int *medianas = (int*)malloc((size_t)g * sizeof(int));
+        if (medianas == NULL) return INT_MAX;
+        GruposMedianas grupos = {arr, l, 0, cheios, medianas};
+        medianasDosGrupos(&grupos);
+        if (cheios < g) {
+            int resto = (int)(n % 5);
+            insertionSort(arr + l + cheios * 5, resto);
+            medianas[cheios] = arr[l + cheios * 5 + resto / 2];
+        }
+        int pivo = kesimoMinimo64(medianas, 0, g - 1, (g + 1) / 2);
+        free(medianas);
+
+        int64_t ini, fim;
+        particionarTresVias64(arr, l, r, pivo, &ini, &fim);
+        if (k - 1 < ini - l) {
+            r = ini - 1;
+        } else if (k - 1 <= fim - l) {
+            return pivo;
+        } else {
+            k -= fim - l + 1;
+            l = fim + 1;
+        }
+    }
+    return INT_MAX;
+}
+
+/* =========================
+   Execução paralela simples
+   =========================
+   executarEmParalelo(nTarefas, nThreads, corpo, ctx) chama
+   corpo(ctx, t) para t = 0..nTarefas-1 usando até nThreads threads do
+   runtime fork-join (forkjoin.h). O intervalo de tarefas é dividido ao
+   meio recursivamente; quem fica sem trabalho rouba metades pendentes.
+   A thread que chama também trabalha. Retorna só quando todas terminaram.
+   Chamada de dentro de outra tarefa, usa os trabalhadores que já existem.
+*/
+
+typedef struct {
+    void (*corpo)(void *ctx, int tarefa);
+    void *ctx;
+    int ini, fim;
+} LacoParalelo;
+
+static void executarFaixa(void *arg) {
+    LacoParalelo *laco = (LacoParalelo*)arg;
+    if (laco->fim - laco->ini == 1) {
+        laco->corpo(laco->ctx, laco->ini);
+        return;
+    }
+    int meio = laco->ini + (laco->fim - laco->ini) / 2;
+    LacoParalelo esquerda = {laco->corpo, laco->ctx, laco->ini, meio};
+    LacoParalelo direita = {laco->corpo, laco->ctx, meio, laco->fim};
+    TarefaFJ t;
+    fjCriar(&t, executarFaixa, &direita);
+    executarFaixa(&esquerda);
+    fjEsperar(&t);
+}
+
+void executarEmParalelo(int nTarefas, int nThreads, void (*corpo)(void *ctx, int tarefa), void *ctx) {
+    if (nTarefas <= 0) return;
+    LacoParalelo laco = {corpo, ctx, 0, nTarefas};
+    fjExecutar(nThreads < nTarefas ? nThreads : nTarefas, executarFaixa, &laco);
+}
+
+/* =========================
+   Ordenação (introsort / pdqsort simplificado)
+   =========================
+   Reaproveita as peças da seleção:
+   - particionarSemDesvio: Lomuto sem desvios no laço;
+   - redes de comparadores para fatias com até LIMITE_REDE elementos;
+   - kesimoMinimo (mediana das medianas) como pivô de emergência quando
+     a recursão fica funda demais => O(n log n) garantido.
+   Além disso, detecta fatias já crescentes (retorna), decrescentes
+   (inverte) ou quase crescentes (insertion sort com poucos
+   deslocamentos), e trata repetições como o pdqsort: se o pivô é igual
+   ao elemento logo antes da fatia, tudo que ficou à esquerda é igual a
+   ele. Depois de uma partição muito desequilibrada, troca alguns
+   elementos de cada lado de lugar (também como o pdqsort) para quebrar
+   padrões (tubo de órgão, dente de serra) que enganam o ninther.
+*/
+
+/*
+ * particionarSemDesvio: mesmo contrato de particionar (Lomuto com <=),
+ * mas recebe o ÍNDICE do pivô e o laço não tem if: cada passo troca
+ * arr[i] com arr[j] e avança i só quando arr[j] <= pivo.
+ */
+int particionarSemDesvio(int arr[], int l, int r, int p) {
+    trocar(&arr[p], &arr[r]);
+    int pivo = arr[r];
+    int i = l;
+    EST_CONTAR(comparacoesParticao, r - l);
+    EST_CONTAR(trocas, r - l);
+    for (int j = l; j <= r - 1; j++) {
+        int x = arr[j];
+        arr[j] = arr[i];
+        arr[i] = x;
+        i += x <= pivo;
+    }
+    trocar(&arr[i], &arr[r]);
+    return i;
+}
+
+// Índice da mediana de arr[a], arr[b], arr[c].
+static int indiceMediana3(const int arr[], int a, int b, int c) {
+    if (arr[a] < arr[b]) {
+        if (arr[b] < arr[c]) return b;
+        return arr[a] < arr[c] ? c : a;
+    }
+    if (arr[a] < arr[c]) return a;
+    return arr[b] < arr[c] ? c : b;
+}
+
+#define LIMITE_INSERCAO_PARCIAL 8   // deslocamentos antes de desistir
+
+/*
+ * Termina de ordenar arr[l..r] por inserção, sabendo que arr[l..i] já
+ * está crescente. Desiste (retorna 0) quando o total de deslocamentos
+ * passa de LIMITE_INSERCAO_PARCIAL; arr continua uma permutação válida.
+ */
+static int insercaoParcial(int arr[], int l, int i, int r) {
+    int deslocados = 0;
+    for (int j = i + 1; j <= r; j++) {
+        int x = arr[j], t = j - 1;
+        while (t >= l && arr[t] > x) {
+            arr[t + 1] = arr[t];
+            t--;
+        }
+        arr[t + 1] = x;
+        deslocados += j - 1 - t;
+        if (deslocados > LIMITE_INSERCAO_PARCIAL && j < r) return 0;
+    }
+    return 1;
+}
+
+/*
+ * 1 se arr[l..r] já está crescente, ou se ficou ordenado porque estava
+ * decrescente (inverte) ou quase crescente (insercaoParcial).
+ */
+static int tratarSequenciaPronta(int arr[], int l, int r) {
+    int i = l;
+    while (i < r && arr[i] <= arr[i + 1]) i++;
+    if (i == r) return 1;
+    if (i > l) return insercaoParcial(arr, l, i, r);   // começou crescendo e depois quebrou
+    while (i < r && arr[i] >= arr[i + 1]) i++;
+    if (i < r) return 0;
+    for (int a = l, b = r; a < b; a++, b--) trocar(&arr[a], &arr[b]);
+    return 1;
+}
+
+// Troca alguns elementos de arr[a..b] de lugar para quebrar padrões.
+static void quebrarPadrao(int arr[], int a, int b) {
+    int m = b - a + 1;
+    if (m <= LIMITE_REDE) return;
+    int q = m / 4;
+    trocar(&arr[a], &arr[a + q]);
+    trocar(&arr[b], &arr[b - q]);
+    if (m > 128) {
+        trocar(&arr[a + 1], &arr[a + q + 1]);
+        trocar(&arr[a + 2], &arr[a + q + 2]);
+        trocar(&arr[b - 1], &arr[b - q - 1]);
+        trocar(&arr[b - 2], &arr[b - q - 2]);
+    }
+}
+
+#define CORTE_ORDENAR_PARALELO (1 << 16)
+
+typedef struct {
+    int *arr;
+    int l, r;
+    int profundidade;   // níveis restantes antes do pivô de emergência
+    int antecessor;     // 1 se arr[l-1] existe e é <= todo arr[l..r]
+} TarefaOrdenar;
+
+static void ordenarTarefa(void *arg);
+
+static void ordenarRec(int arr[], int l, int r, int profundidade, int antecessor, int paralelo) {
+    while (r - l + 1 > LIMITE_REDE) {
+        int n = r - l + 1;
+        if (tratarSequenciaPronta(arr, l, r)) break;
+
+        if (profundidade-- == 0) {
+            // Pivô de emergência: a mediana exata, com partição em três vias.
+            int ini, fim;
+            int pivo = kesimoMinimo(arr, l, r, (n + 1) / 2);
+            particionarTresVias(arr, l, r, pivo, &ini, &fim);
+            ordenarRec(arr, l, ini - 1, profundidade, antecessor, paralelo);
+            l = fim + 1;
+            antecessor = 1;
+            continue;
+        }
+
+        // Pivô: mediana de 3, ou "ninther" (mediana de 3 medianas) se n é grande.
+        int meio = l + n / 2;
+        int p;
+        if (n >= 128) {
+            int s = n / 8;
+            p = indiceMediana3(arr,
+                               indiceMediana3(arr, l, l + s, l + 2 * s),
+                               indiceMediana3(arr, meio - s, meio, meio + s),
+                               indiceMediana3(arr, r - 2 * s, r - s, r));
+        } else {
+            p = indiceMediana3(arr, l, meio, r);
+        }
+
+        // Pivô igual ao antecessor: a parte <= pivô é toda igual, só falta a direita.
+        if (antecessor && arr[l - 1] == arr[p]) {
+            l = particionarSemDesvio(arr, l, r, p) + 1;
+            continue;
+        }
+
+        int pos = particionarSemDesvio(arr, l, r, p);
+
+        // Lado menor com menos de 1/8: embaralha um pouco os dois lados
+        if (pos - l < n / 8 || r - pos < n / 8) {
+            quebrarPadrao(arr, l, pos - 1);
+            quebrarPadrao(arr, pos + 1, r);
+        }
+
+        if (paralelo && n >= CORTE_ORDENAR_PARALELO) {
+            // O lado menor vira tarefa (pode ser roubada); este segue com o maior.
+            TarefaOrdenar filha;
+            TarefaFJ t;
+            filha.arr = arr;
+            filha.profundidade = profundidade;
+            if (pos - l < r - pos) {
+                filha.l = l; filha.r = pos - 1; filha.antecessor = antecessor;
+                fjCriar(&t, ordenarTarefa, &filha);
+                ordenarRec(arr, pos + 1, r, profundidade, 1, paralelo);
+            } else {
+                filha.l = pos + 1; filha.r = r; filha.antecessor = 1;
+                fjCriar(&t, ordenarTarefa, &filha);
+                ordenarRec(arr, l, pos - 1, profundidade, antecessor, paralelo);
+            }
+            fjEsperar(&t);
+            return;
+        }
+
+        // Recursão no lado menor e laço no maior: pilha O(log n).
+        if (pos - l < r - pos) {
+            ordenarRec(arr, l, pos - 1, profundidade, antecessor, paralelo);
+            l = pos + 1;
+            antecessor = 1;
+        } else {
+            ordenarRec(arr, pos + 1, r, profundidade, 1, paralelo);
+            r = pos - 1;
+        }
+    }
+
+    int n = r - l + 1;
+    if (n > 1 && n <= LIMITE_REDE) {
+        inicializarRedesSelecao();
+        aplicarRede(arr + l, redesPool + redesInicio[n][0], redesTam[n][0]);
+    }
+}
+
+static void ordenarTarefa(void *arg) {
+    TarefaOrdenar *t = (TarefaOrdenar*)arg;
+    ordenarRec(t->arr, t->l, t->r, t->profundidade, t->antecessor, 1);
+}
+
+// 2 * floor(log2(n)): limite de profundidade antes do pivô de emergência.
+static int limiteProfundidade(int n) {
+    int d = 0;
+    while (n > 1) { n >>= 1; d++; }
+    return 2 * d;
+}
+
+/*
+ * ordenar(arr, n): ordena arr[0..n-1] em ordem crescente.
+ * O(n log n) no pior caso; O(n) para entradas já ordenadas ou invertidas.
+ */
+void ordenar(int arr[], int n) {
+    if (n > 1) ordenarRec(arr, 0, n - 1, limiteProfundidade(n), 0, 0);
+}
+
+/*
+ * ordenarParalelo(arr, n, nThreads): igual a ordenar, mas depois de cada
+ * partição grande (>= CORTE_ORDENAR_PARALELO) o lado menor vira uma
+ * tarefa do runtime fork-join, roubável por até nThreads - 1 threads.
+ */
+static void ordenarRaiz(void *arg) {
+    TarefaOrdenar *t = (TarefaOrdenar*)arg;
+    inicializarRedesSelecao();   // antes de qualquer tarefa chegar às redes
+    ordenarRec(t->arr, t->l, t->r, t->profundidade, 0, 1);
+}
+
+void ordenarParalelo(int arr[], int n, int nThreads) {
+    if (n <= 1) return;
+    TarefaOrdenar raiz = {arr, 0, n - 1, limiteProfundidade(n), 0};
+    fjExecutar(nThreads, ordenarRaiz, &raiz);
+}
+
+/* =========================
+   Lote de seleções independentes
+   =========================
+   Milhões de seleções pequenas/médias (ex.: mediana por usuário) sobre
+   um buffer compartilhado. Chamar kesimoMinimo uma a uma gasta mais em
+   recursão e VLA do que em trabalho útil, então as tarefas são
+   separadas por classe de tamanho:
+   - pequenas (<= LIMITE_REDE): agrupadas por (tam, k) e resolvidas em
+     blocos com kesimoRedeLote (SIMD atravessando as tarefas);
+   - médias: kesimoRapido, juntando várias tarefas por unidade de trabalho;
+   - grandes (>= CORTE_LOTE_GRANDE): uma unidade de trabalho cada, e as
+     maiores entram primeiro na fila para equilibrar as threads. A partir
+     de CORTE_LOTE_PARALELO (com nThreads > 1) a própria tarefa também é
+     dividida: uma amostra escolhe dois pivôs em volta do posto k e a
+     passada que separa a faixa entre eles corre em paralelo.
+*/
+
+/*
+ * kesimoRapido(arr, l, r, k): mesmo contrato de kesimoMinimo, mas com
+ * pivô barato (mediana de 3 / ninther) e particionarSemDesvio.
+ * Se o trabalho acumulado passar de 4n (pivôs ruins ou muitas
+ * repetições), termina com kesimoMinimo: continua O(n) no pior caso.
+ */
+int kesimoRapido(int arr[], int l, int r, int k) {
+    if (k <= 0 || k > r - l + 1) return INT_MAX;
+    long long orcamento = 4LL * (r - l + 1);
+
+    while (r - l + 1 > LIMITE_REDE) {
+        int n = r - l + 1;
+        if (orcamento < 0) return kesimoMinimo(arr, l, r, k);
+        orcamento -= n;
+
+        int meio = l + n / 2, p;
+        if (n >= 128) {
+            int s = n / 8;
+            p = indiceMediana3(arr,
+                               indiceMediana3(arr, l, l + s, l + 2 * s),
+                               indiceMediana3(arr, meio - s, meio, meio + s),
+                               indiceMediana3(arr, r - 2 * s, r - s, r));
+        } else {
+            p = indiceMediana3(arr, l, meio, r);
+        }
+
+        int pos = particionarSemDesvio(arr, l, r, p);
+        if (pos - l == k - 1) return arr[pos];
+        if (pos - l > k - 1) {
+            r = pos - 1;
+        } else {
+            k -= pos - l + 1;
+            l = pos + 1;
+        }
+    }
+    return kesimoRede(arr + l, r - l + 1, k);
+}
+
+typedef struct {
+    long offset;   // início da tarefa no buffer
+    int tam;       // quantidade de elementos
+    int k;         // 1-based
+} TarefaSelecao;
+
+#define CORTE_LOTE_GRANDE (1 << 16)
+#define CORTE_LOTE_PARALELO (1 << 20)     // tarefas divididas entre as threads
+#define PEDACO_PARTICAO (1 << 16)         // elementos por tarefa dentro de uma seleção grande
+#define ELEMENTOS_POR_UNIDADE (1 << 16)   // alvo de trabalho por unidade média
+#define TAREFAS_PEQUENAS_POR_UNIDADE 1024
+
+/*
+ * Seleção grande em paralelo (estilo Floyd-Rivest): uma amostra
+ * ordenada dá dois pivôs lo <= hi em volta do posto k; com alta
+ * probabilidade o k-ésimo está entre eles, junto com poucos elementos.
+ * Uma passada em paralelo, em pedaços de PEDACO_PARTICAO elementos (uma
+ * tarefa fork-join cada): o pedaço conta seus < lo e copia, sem desvio,
+ * seus lo..hi para o mesmo trecho de 'faixa'. Depois os trechos são
+ * juntados e o k-ésimo sai de kesimoRapido sobre a faixa. 'dados' só é lido.
+ */
+#define AMOSTRA_LOTE_PARALELO 16384
+#define MARGEM_LOTE_PARALELO 384   // postos da amostra de cada lado de k
+
+typedef struct {
+    const int *dados;
+    int *faixa;
+    int n, lo, hi;
+    int *contagens;     // 2 por pedaço: < lo e lo..hi
+    int p0, p1;         // pedaços [p0, p1)
+} FaixaParalela;
+
+static void faixaParalelaPedacos(void *arg) {
+    FaixaParalela *fp = (FaixaParalela*)arg;
+    if (fp->p1 - fp->p0 > 1) {
+        FaixaParalela esquerda = *fp, direita = *fp;
+        esquerda.p1 = direita.p0 = fp->p0 + (fp->p1 - fp->p0) / 2;
+        TarefaFJ t;
+        fjCriar(&t, faixaParalelaPedacos, &direita);
+        faixaParalelaPedacos(&esquerda);
+        fjEsperar(&t);
+        return;
     }
-    
+    int ini = fp->p0 * PEDACO_PARTICAO;
+    int tam = fp->n - ini > PEDACO_PARTICAO ? PEDACO_PARTICAO : fp->n - ini;
+    const int *restrict d = fp->dados + ini;
+    int *restrict f = fp->faixa + ini;
+    int lo = fp->lo, hi = fp->hi, menores = 0, dentro = 0;
+    for (int i = 0; i < tam; i++) {
+        int x = d[i];
+        f[dentro] = x;
+        menores += x < lo;
+        dentro += (x >= lo) & (x <= hi);
+    }
+    fp->contagens[2 * fp->p0] = menores;
+    fp->contagens[2 * fp->p0 + 1] = dentro;
+}
+
+/*
+ * k-ésimo menor de arr[0..n-1] (n grande) com a passada sobre os dados
+ * em paralelo. Se o k-ésimo cair fora da faixa (raro) ou faltar memória,
+ * é kesimoRapido sobre tudo.
+ */
+static int kesimoGrandeParalelo(int arr[], int n, int k) {
+    int nPedacos = (n + PEDACO_PARTICAO - 1) / PEDACO_PARTICAO;
+    int *amostra = (int*)malloc(AMOSTRA_LOTE_PARALELO * sizeof(int));
+    int *contagens = (int*)malloc((size_t)nPedacos * 2 * sizeof(int));
+    int *faixa = (int*)malloc((size_t)n * sizeof(int));
+    if (amostra == NULL || contagens == NULL || faixa == NULL) {
+        free(amostra); free(contagens); free(faixa);
+        return kesimoRapido(arr, 0, n - 1, k);
+    }
+
+    unsigned x = 2463534242u ^ (unsigned)n ^ ((unsigned)k << 7);
+    for (int i = 0; i < AMOSTRA_LOTE_PARALELO; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        amostra[i] = arr[x % (unsigned)n];
+    }
+    ordenar(amostra, AMOSTRA_LOTE_PARALELO);
+    long long posto = (long long)k * AMOSTRA_LOTE_PARALELO / n;
+    int a = posto - MARGEM_LOTE_PARALELO < 0 ? 0 : (int)posto - MARGEM_LOTE_PARALELO;
+    int b = posto + MARGEM_LOTE_PARALELO >= AMOSTRA_LOTE_PARALELO ? AMOSTRA_LOTE_PARALELO - 1 : (int)posto + MARGEM_LOTE_PARALELO;
+    // nas pontas, a faixa vai até o extremo (sem perder o k-ésimo)
+    int lo = a == 0 ? INT_MIN : amostra[a], hi = b == AMOSTRA_LOTE_PARALELO - 1 ? INT_MAX : amostra[b];
+    free(amostra);
+
+    FaixaParalela fp = {arr, faixa, n, lo, hi, contagens, 0, nPedacos};
+    faixaParalelaPedacos(&fp);
+
+    // junta os trechos de cada pedaço no início de 'faixa'
+    int menores = 0, dentro = 0;
+    for (int p = 0; p < nPedacos; p++) {
+        const int *trecho = faixa + (size_t)p * PEDACO_PARTICAO;
+        for (int i = 0; i < contagens[2 * p + 1]; i++) faixa[dentro + i] = trecho[i];
+        menores += contagens[2 * p];
+        dentro += contagens[2 * p + 1];
+    }
+
+    int resultado;
+    if (k > menores && k <= menores + dentro)
+        resultado = kesimoRapido(faixa, 0, dentro - 1, k - menores);
+    else
+        resultado = kesimoRapido(arr, 0, n - 1, k);
+    free(contagens);
+    free(faixa);
+    return resultado;
+}
+
+typedef enum { UNIDADE_REDE, UNIDADE_MEDIA, UNIDADE_GRANDE } TipoUnidade;
+
+typedef struct {
+    TipoUnidade tipo;
+    int ini, fim;   // intervalo em 'ordem' (índices de tarefas)
+} UnidadeLote;
+
+typedef struct {
+    int *buffer;
+    const TarefaSelecao *tarefas;
+    int *resultados;
+    const int *ordem;
+    const UnidadeLote *unidades;
+} Lote;
+
+static void executarUnidadeLote(void *ctx, int u) {
+    Lote *lote = (Lote*)ctx;
+    const UnidadeLote *un = &lote->unidades[u];
+
+    if (un->tipo == UNIDADE_GRANDE) {
+        const TarefaSelecao *t = &lote->tarefas[lote->ordem[un->ini]];
+        lote->resultados[lote->ordem[un->ini]] = kesimoGrandeParalelo(lote->buffer + t->offset, t->tam, t->k);
+        return;
+    }
+
+    if (un->tipo == UNIDADE_MEDIA) {
+        for (int i = un->ini; i < un->fim; i++) {
+            const TarefaSelecao *t = &lote->tarefas[lote->ordem[i]];
+            lote->resultados[lote->ordem[i]] = kesimoRapido(lote->buffer + t->offset, 0, t->tam - 1, t->k);
+        }
+        return;
+    }
+
+    // Todas as tarefas da unidade têm o mesmo (tam, k): monta os blocos
+    // transpostos direto do buffer, sem passar pelo layout de kesimoRedeLote.
+    int bloco[LIMITE_REDE][LOTE_REDE] = {{0}};
+    int tam = lote->tarefas[lote->ordem[un->ini]].tam;
+    int k = lote->tarefas[lote->ordem[un->ini]].k;
+    const Comparador *rede = redesPool + redesInicio[tam][k];
+    for (int base = un->ini; base < un->fim; base += LOTE_REDE) {
+        int m = un->fim - base < LOTE_REDE ? un->fim - base : LOTE_REDE;
+        for (int j = 0; j < m; j++) {
+            const int *origem = lote->buffer + lote->tarefas[lote->ordem[base + j]].offset;
+            for (int w = 0; w < tam; w++) bloco[w][j] = origem[w];
+        }
+        aplicarRedeBloco(bloco, rede, redesTam[tam][k]);
+        for (int j = 0; j < m; j++) lote->resultados[lote->ordem[base + j]] = bloco[k - 1][j];
+    }
+}
+
+/*
+ * kesimoLote(buffer, tarefas, nTarefas, resultados, nThreads):
+ * - resultados[i] = k-ésimo menor de buffer[offset .. offset + tam - 1]
+ *   da tarefa i (INT_MAX se k ou tam forem inválidos).
+ * - Os intervalos das tarefas não podem se sobrepor: as médias e grandes
+ *   reorganizam seu trecho do buffer (as pequenas não o alteram).
+ * - Retorna 0 em caso de sucesso e -1 se faltar memória.
+ */
+int kesimoLote(int buffer[], const TarefaSelecao tarefas[], int nTarefas, int resultados[], int nThreads) {
+    if (nTarefas <= 0) return 0;
+    inicializarRedesSelecao();
+
+    // 1) Classes: pequenas ordenadas por (tam, k) com counting sort; o resto à parte.
+    int nChaves = (LIMITE_REDE + 1) * (LIMITE_REDE + 1);
+    int *contagem = (int*)calloc(nChaves + 1, sizeof(int));
+    int *ordem = (int*)malloc((size_t)nTarefas * sizeof(int));
+    if (contagem == NULL || ordem == NULL) {
+        free(contagem);
+        free(ordem);
+        return -1;
+    }
+    int nPequenas = 0, nGrandes = 0, nMedias = 0;
+    for (int i = 0; i < nTarefas; i++) {
+        const TarefaSelecao *t = &tarefas[i];
+        if (t->tam <= 0 || t->k <= 0 || t->k > t->tam) {
+            resultados[i] = INT_MAX;
+        } else if (t->tam <= LIMITE_REDE) {
+            contagem[t->tam * (LIMITE_REDE + 1) + t->k + 1]++;
+            nPequenas++;
+        } else if (t->tam >= CORTE_LOTE_GRANDE) {
+            nGrandes++;
+        } else {
+            nMedias++;
+        }
+    }
+    for (int c = 0; c < nChaves; c++) contagem[c + 1] += contagem[c];
+    int proxGrande = nPequenas, proxMedia = nPequenas + nGrandes;
+    for (int i = 0; i < nTarefas; i++) {
+        const TarefaSelecao *t = &tarefas[i];
+        if (t->tam <= 0 || t->k <= 0 || t->k > t->tam) continue;
+        if (t->tam <= LIMITE_REDE) ordem[contagem[t->tam * (LIMITE_REDE + 1) + t->k]++] = i;
+        else if (t->tam >= CORTE_LOTE_GRANDE) ordem[proxGrande++] = i;
+        else ordem[proxMedia++] = i;
+    }
+    free(contagem);
+
+    // Grandes em ordem decrescente de tamanho (as mais caras saem primeiro)
+    for (int a = nPequenas + 1; a < nPequenas + nGrandes; a++) {
+        int chave = ordem[a], b = a - 1;
+        while (b >= nPequenas && tarefas[ordem[b]].tam < tarefas[chave].tam) {
+            ordem[b + 1] = ordem[b];
+            b--;
+        }
+        ordem[b + 1] = chave;
+    }
+
+    // 2) Unidades de trabalho: grandes (1 cada), médias (~ELEMENTOS_POR_UNIDADE), pequenas por grupo.
+    UnidadeLote *unidades = (UnidadeLote*)malloc(((size_t)nTarefas + 1) * sizeof(UnidadeLote));
+    if (unidades == NULL) {
+        free(ordem);
+        return -1;
+    }
+    int nUnidades = 0;
+    for (int i = nPequenas; i < nPequenas + nGrandes; i++) {
+        int paralela = nThreads > 1 && tarefas[ordem[i]].tam >= CORTE_LOTE_PARALELO;
+        unidades[nUnidades++] = (UnidadeLote){paralela ? UNIDADE_GRANDE : UNIDADE_MEDIA, i, i + 1};
+    }
+    for (int i = nPequenas + nGrandes; i < proxMedia;) {
+        int j = i;
+        long elementos = 0;
+        while (j < proxMedia && elementos < ELEMENTOS_POR_UNIDADE) elementos += tarefas[ordem[j++]].tam;
+        unidades[nUnidades++] = (UnidadeLote){UNIDADE_MEDIA, i, j};
+        i = j;
+    }
+    for (int i = 0; i < nPequenas;) {
+        int j = i;
+        const TarefaSelecao *t0 = &tarefas[ordem[i]];
+        while (j < nPequenas && j - i < TAREFAS_PEQUENAS_POR_UNIDADE &&
+               tarefas[ordem[j]].tam == t0->tam && tarefas[ordem[j]].k == t0->k) j++;
+        unidades[nUnidades++] = (UnidadeLote){UNIDADE_REDE, i, j};
+        i = j;
+    }
+
+    Lote lote = {buffer, tarefas, resultados, ordem, unidades};
+    executarEmParalelo(nUnidades, nThreads, executarUnidadeLote, &lote);
+
+    free(unidades);
+    free(ordem);
+    return 0;
+}
+
+/* =========================
+   Seleção incremental (fatiada no tempo)
+   =========================
+   Para rodar uma seleção grande numa thread que também atende trabalho
+   sensível a latência: todo o estado (intervalo atual, k, fase e os
+   cursores da partição) fica em SelecaoIncremental, não na pilha, e
+   selecaoPasso faz no máximo 'orcamento' unidades de trabalho por
+   chamada (uma unidade ~ um elemento visitado).
+   - Pivô: mediana de 3 posições aleatórias (O(1) por escolha, então a
+     pausa continua limitada); tempo total O(n) esperado.
+   - Partição em três vias (< pivô | == pivô | > pivô) retomável
+     elemento a elemento; repetições não degradam a seleção.
+   - Fatias com até LIMITE_REDE elementos terminam de uma vez com
+     kesimoRede: o passo pode passar do orçamento em até LIMITE_REDE.
+*/
+
+typedef enum {
+    SELECAO_ESCOLHER_PIVO,
+    SELECAO_PARTICIONAR,
+    SELECAO_CONCLUIDA
+} FaseSelecao;
+
+typedef struct {
+    int *arr;
+    int l, r, k;        // procura o k-ésimo (1-based) de arr[l..r]
+    FaseSelecao fase;
+    int pivo;
+    int menores, i, maiores;   // cursores: arr[l..menores-1] < pivo, arr[maiores+1..r] > pivo
+    int resultado;
+    unsigned int semente;
+} SelecaoIncremental;
+
+// Prepara a seleção do k-ésimo menor (1-based) de arr[l..r]; não faz trabalho.
+void selecaoIniciar(SelecaoIncremental *s, int arr[], int l, int r, int k) {
+    s->arr = arr;
+    s->l = l;
+    s->r = r;
+    s->k = k;
+    s->semente = 2463534242u ^ (unsigned int)(r - l);
+    s->resultado = INT_MAX;
+    s->fase = (k > 0 && k <= r - l + 1) ? SELECAO_ESCOLHER_PIVO : SELECAO_CONCLUIDA;
+}
+
+static int selecaoAleatorio(SelecaoIncremental *s, int n) {
+    // xorshift32: estado próprio, sem depender de rand()
+    s->semente ^= s->semente << 13;
+    s->semente ^= s->semente >> 17;
+    s->semente ^= s->semente << 5;
+    return (int)(s->semente % (unsigned int)n);
+}
+
+/*
+ * selecaoPasso(s, orcamento):
+ * - Avança a seleção gastando até ~orcamento unidades de trabalho.
+ * - Retorna 1 quando terminou (valor em s->resultado; INT_MAX se k
+ *   era inválido) e 0 se ainda falta.
+ * - arr[l..r] é reorganizado ao longo dos passos e não pode ser
+ *   alterado por fora até a seleção terminar.
+ */
+int selecaoPasso(SelecaoIncremental *s, long orcamento) {
+    int *arr = s->arr;
+    while (s->fase != SELECAO_CONCLUIDA && orcamento > 0) {
+        int n = s->r - s->l + 1;
+
+        if (s->fase == SELECAO_ESCOLHER_PIVO) {
+            if (n <= LIMITE_REDE) {
+                s->resultado = kesimoRede(arr + s->l, n, s->k);
+                s->fase = SELECAO_CONCLUIDA;
+                break;
+            }
+            int a = s->l + selecaoAleatorio(s, n);
+            int b = s->l + selecaoAleatorio(s, n);
+            int c = s->l + selecaoAleatorio(s, n);
+            s->pivo = arr[indiceMediana3(arr, a, b, c)];
+            s->menores = s->i = s->l;
+            s->maiores = s->r;
+            s->fase = SELECAO_PARTICIONAR;
+            orcamento -= 3;
+            continue;
+        }
+
+        // SELECAO_PARTICIONAR: processa até 'orcamento' elementos
+        int pivo = s->pivo, menores = s->menores, i = s->i, maiores = s->maiores;
+        long limite = orcamento < (long)(maiores - i + 1) ? orcamento : (long)(maiores - i + 1);
+        for (long passo = 0; passo < limite; passo++) {
+            int x = arr[i];
+            if (x < pivo) trocar(&arr[menores++], &arr[i++]);
+            else if (x > pivo) trocar(&arr[i], &arr[maiores--]);
+            else i++;
+        }
+        orcamento -= limite;
+        s->menores = menores;
+        s->i = i;
+        s->maiores = maiores;
+        if (i <= maiores) break;   // orçamento acabou no meio da partição
+
+        // Partição pronta: [menores..maiores] são os iguais ao pivô
+        if (s->k - 1 < menores - s->l) {
+            s->r = menores - 1;
+        } else if (s->k - 1 <= maiores - s->l) {
+            s->resultado = pivo;
+            s->fase = SELECAO_CONCLUIDA;
+            break;
+        } else {
+            s->k -= maiores - s->l + 1;
+            s->l = maiores + 1;
+        }
+        s->fase = SELECAO_ESCOLHER_PIVO;
+    }
+    return s->fase == SELECAO_CONCLUIDA;
+}
+
+/* =========================
+   Seleção ponderada
+   =========================
+   Cada chave arr[i] carrega um peso pesos[i] >= 0. Em vez de expandir
+   as chaves em duplicatas, procuramos diretamente o elemento onde o
+   peso acumulado (na ordem crescente das chaves) atinge uma fração
+   'alvo' do peso total. Com alvo = 0.5 temos a mediana ponderada.
+*/
+
+// Inteiro pseudoaleatório em [0, n). Combina duas chamadas de rand()
+// porque RAND_MAX pode ser só 32767 em algumas plataformas.
+int aleatorioAte(int n) {
+    unsigned int x = ((unsigned int)rand() << 15) ^ (unsigned int)rand();
+    return (int)(x % (unsigned int)n);
+}
+
+/*
+ * particionarTresViasPonderado: particionarTresVias com um VALOR de pivô,
+ * mas cada troca em arr é repetida em pesos, mantendo os pares
+ * (chave, peso) juntos. Todas as cópias do pivô ficam numa faixa só,
+ * [*ini..*fim], então chaves repetidas não degradam para O(n²).
+ */
+static void particionarTresViasPonderado(int arr[], double pesos[], int l, int r, int pivo,
+                                         int *ini, int *fim) {
+    int lt = l, i = l, gt = r;
+    double tempPeso;
+    while (i <= gt) {
+        if (arr[i] < pivo) {
+            trocar(&arr[lt], &arr[i]);
+            tempPeso = pesos[lt]; pesos[lt] = pesos[i]; pesos[i] = tempPeso;
+            lt++; i++;
+        } else if (arr[i] > pivo) {
+            trocar(&arr[i], &arr[gt]);
+            tempPeso = pesos[i]; pesos[i] = pesos[gt]; pesos[gt] = tempPeso;
+            gt--;
+        } else {
+            i++;
+        }
+    }
+    *ini = lt;
+    *fim = gt;
+}
+
+/*
+ * selecaoPonderadaRec: procura em arr[l..r] a chave onde o peso acumulado
+ * alcança 'meta' (peso absoluto, já descontado o que ficou à esquerda de l).
+ * Pivô aleatório => O(n) esperado, também com chaves repetidas: a faixa
+ * igual ao pivô inteira sai de uma vez, com o peso somado.
+ */
+static int selecaoPonderadaRec(int arr[], double pesos[], int l, int r, double meta) {
+    while (l < r) {
+        int ini, fim;
+        particionarTresViasPonderado(arr, pesos, l, r, arr[l + aleatorioAte(r - l + 1)], &ini, &fim);
+
+        double pesoEsq = 0.0, pesoIgual = 0.0; // pesos de arr[l..ini-1] e arr[ini..fim]
+        for (int i = l; i < ini; i++) pesoEsq += pesos[i];
+        for (int i = ini; i <= fim; i++) pesoIgual += pesos[i];
+
+        if (ini > l && pesoEsq >= meta) {
+            r = ini - 1;                      // cruza a meta antes do pivô
+        } else if (pesoEsq + pesoIgual >= meta || fim == r) {
+            return arr[ini];                  // o pivô é quem cruza a meta
+        } else {
+            meta -= pesoEsq + pesoIgual;      // segue para a direita
+            l = fim + 1;
+        }
+    }
+    return arr[l];
+}
+
+/*
+ * kesimoPonderado(arr, pesos, n, alvo):
+ * - Retorna a menor chave x tal que a soma dos pesos das chaves <= x
+ *   é pelo menos alvo * (peso total). 'alvo' em [0, 1].
+ * - Reorganiza arr e pesos (juntos), como kesimoMinimo reorganiza arr.
+ * - Retorna INT_MAX se n <= 0 ou se o peso total não for positivo.
+ */
+int kesimoPonderado(int arr[], double pesos[], int n, double alvo) {
+    if (n <= 0) return INT_MAX;
+
+    double total = 0.0;
+    for (int i = 0; i < n; i++) total += pesos[i];
+    if (total <= 0.0) return INT_MAX;
+
+    if (alvo < 0.0) alvo = 0.0;
+    if (alvo > 1.0) alvo = 1.0;
+    return selecaoPonderadaRec(arr, pesos, 0, n - 1, alvo * total);
+}
+
+/*
+ * quantisPonderadosRec: resolve várias metas de uma vez.
+ * 'ordem[qi..qf]' são índices de metas em ordem crescente; cada
+ * particionamento divide as metas entre esquerda, faixa do pivô e
+ * direita, então o trabalho de particionar é compartilhado entre elas.
+ * 'base' é o peso acumulado de tudo que está antes de arr[l].
+ * Recursão só no lado menor e laço no maior: profundidade O(log n).
+ */
+static void quantisPonderadosRec(int arr[], double pesos[], int l, int r, double base,
+                                 const double metas[], const int ordem[], int qi, int qf,
+                                 int saida[]) {
+    while (qi <= qf) {
+        if (l >= r) {
+            for (int q = qi; q <= qf; q++) saida[ordem[q]] = arr[l];
+            return;
+        }
+
+        int ini, fim;
+        particionarTresViasPonderado(arr, pesos, l, r, arr[l + aleatorioAte(r - l + 1)], &ini, &fim);
+
+        double pesoEsq = 0.0, pesoIgual = 0.0;
+        for (int i = l; i < ini; i++) pesoEsq += pesos[i];
+        for (int i = ini; i <= fim; i++) pesoIgual += pesos[i];
+        double limiteEsq = base + pesoEsq;              // fim da parte esquerda
+        double limitePivo = limiteEsq + pesoIgual;      // fim da faixa do pivô
+
+        // metas [qi..q1-1] vão para a esquerda, [q1..q2-1] são o pivô, resto à direita
+        int q1 = qi;
+        if (ini > l)
+            while (q1 <= qf && metas[ordem[q1]] <= limiteEsq) q1++;
+        int q2 = q1;
+        while (q2 <= qf && (metas[ordem[q2]] <= limitePivo || fim == r)) q2++;
+
+        for (int q = q1; q < q2; q++) saida[ordem[q]] = arr[ini];
+        if (ini - l < r - fim) {
+            quantisPonderadosRec(arr, pesos, l, ini - 1, base, metas, ordem, qi, q1 - 1, saida);
+            l = fim + 1; base = limitePivo; qi = q2;
+        } else {
+            quantisPonderadosRec(arr, pesos, fim + 1, r, limitePivo, metas, ordem, q2, qf, saida);
+            r = ini - 1; qf = q1 - 1;
+        }
+    }
+}
+
+/*
+ * quantisPonderados(arr, pesos, n, alvos, nq, saida):
+ * - Para cada alvos[q] em [0, 1], grava em saida[q] o mesmo resultado
+ *   que kesimoPonderado(arr, pesos, n, alvos[q]) daria.
+ * - Os alvos podem vir em qualquer ordem.
+ * - Retorna 0 em caso de sucesso e -1 para entrada inválida ou falta
+ *   de memória.
+ */
+int quantisPonderados(int arr[], double pesos[], int n, const double alvos[], int nq, int saida[]) {
+    if (n <= 0 || nq <= 0) return -1;
+
+    double total = 0.0;
+    for (int i = 0; i < n; i++) total += pesos[i];
+    if (total <= 0.0) return -1;
+
+    double *metas = (double*)malloc((size_t)nq * sizeof(double));
+    int *ordem = (int*)malloc((size_t)nq * sizeof(int));
+    if (metas == NULL || ordem == NULL) {
+        free(metas);
+        free(ordem);
+        return -1;
+    }
+    for (int q = 0; q < nq; q++) {
+        double a = alvos[q] < 0.0 ? 0.0 : (alvos[q] > 1.0 ? 1.0 : alvos[q]);
+        metas[q] = a * total;
+        ordem[q] = q;
+    }
+    // ordena os índices das metas (nq costuma ser pequeno)
+    for (int i = 1; i < nq; i++) {
+        int chave = ordem[i];
+        int j = i - 1;
+        while (j >= 0 && metas[ordem[j]] > metas[chave]) {
+            ordem[j + 1] = ordem[j];
+            j--;
+        }
+        ordem[j + 1] = chave;
+    }
+
+    quantisPonderadosRec(arr, pesos, 0, n - 1, 0.0, metas, ordem, 0, nq - 1, saida);
+
+    free(metas);
+    free(ordem);
+    return 0;
+}
+
+/* =========================
+   Seleção sobre runs ordenados
+   =========================
+   Os dados chegam em m vetores já ordenados (runs). Em vez de
+   concatenar e chamar kesimoMinimo, mantemos para cada run uma janela
+   ativa [lo, hi) e descartamos, a cada rodada, pelo menos 1/4 dos
+   elementos ativos. Nada é movido: só fazemos buscas binárias.
+*/
+
+// Primeira posição em v[lo..hi-1] com v[pos] >= x (ou hi se não houver).
+int limiteInferior(const int v[], int lo, int hi, int x) {
+    while (lo < hi) {
+        int meio = lo + (hi - lo) / 2;
+        if (v[meio] < x) lo = meio + 1;
+        else hi = meio;
+    }
+    return lo;
+}
+
+// Primeira posição em v[lo..hi-1] com v[pos] > x (ou hi se não houver).
+int limiteSuperior(const int v[], int lo, int hi, int x) {
+    while (lo < hi) {
+        int meio = lo + (hi - lo) / 2;
+        if (v[meio] <= x) lo = meio + 1;
+        else hi = meio;
+    }
+    return lo;
+}
+
+/*
+ * kesimoEmRuns(runs, tam, m, k, topK):
+ * - runs[i] é um vetor crescente com tam[i] elementos.
+ * - Retorna o k-ésimo menor (1-based) da união dos runs.
+ * - Se topK != NULL, grava nele os k menores elementos: primeiro os
+ *   estritamente menores que o resultado (na ordem dos runs) e depois
+ *   as cópias do próprio resultado. Não é uma saída ordenada.
+ * - Retorna INT_MAX se k for inválido ou faltar memória.
+ *
+ * Cada rodada usa como pivô a mediana ponderada (kesimoPonderado) dos
+ * elementos centrais das janelas, com peso = tamanho da janela. Assim
+ * pelo menos 1/4 dos ativos fica <= pivô e 1/4 fica >= pivô, e o lado
+ * descartado tem pelo menos esse tamanho: O(log n) rodadas de
+ * O(m log n) cada, sem tocar os dados além das buscas.
+ */
+int kesimoEmRuns(int *runs[], const int tam[], int m, int k, int topK[]) {
+    long long total = 0;
+    for (int i = 0; i < m; i++) total += tam[i];
+    if (m <= 0 || k <= 0 || k > total) return INT_MAX;
+
+    int *lo = (int*)malloc((size_t)m * sizeof(int));
+    int *hi = (int*)malloc((size_t)m * sizeof(int));
+    int *centros = (int*)malloc((size_t)m * sizeof(int));
+    double *pesos = (double*)malloc((size_t)m * sizeof(double));
+    if (lo == NULL || hi == NULL || centros == NULL || pesos == NULL) {
+        free(lo); free(hi); free(centros); free(pesos);
+        return INT_MAX;
+    }
+    for (int i = 0; i < m; i++) { lo[i] = 0; hi[i] = tam[i]; }
+
+    int kRel = k;        // posição procurada dentro das janelas ativas
+    int resultado = INT_MAX;
+    for (;;) {
+        // 1) pivô = mediana ponderada dos centros das janelas não vazias
+        int c = 0;
+        for (int i = 0; i < m; i++) {
+            if (hi[i] > lo[i]) {
+                centros[c] = runs[i][lo[i] + (hi[i] - lo[i]) / 2];
+                pesos[c] = (double)(hi[i] - lo[i]);
+                c++;
+            }
+        }
+        int pivo = kesimoPonderado(centros, pesos, c, 0.5);
+
+        // 2) conta quantos ativos são < pivô e <= pivô
+        long long menores = 0, menoresOuIguais = 0;
+        for (int i = 0; i < m; i++) {
+            menores += limiteInferior(runs[i], lo[i], hi[i], pivo) - lo[i];
+            menoresOuIguais += limiteSuperior(runs[i], lo[i], hi[i], pivo) - lo[i];
+        }
+
+        // 3) decide o lado e encolhe as janelas
+        if (kRel <= menores) {
+            for (int i = 0; i < m; i++) hi[i] = limiteInferior(runs[i], lo[i], hi[i], pivo);
+        } else if (kRel <= menoresOuIguais) {
+            resultado = pivo;
+            break;
+        } else {
+            kRel -= (int)menoresOuIguais;
+            for (int i = 0; i < m; i++) lo[i] = limiteSuperior(runs[i], lo[i], hi[i], pivo);
+        }
+    }
+
+    if (topK != NULL) {
+        int t = 0;
+        for (int i = 0; i < m; i++) {
+            int fim = limiteInferior(runs[i], 0, tam[i], resultado);
+            for (int j = 0; j < fim; j++) topK[t++] = runs[i][j];
+        }
+        while (t < k) topK[t++] = resultado;
+    }
+
+    free(lo); free(hi); free(centros); free(pesos);
+    return resultado;
+}
+
+/* =========================
+   Seleção em matrizes monótonas implícitas (X + Y)
+   =========================
+   O k-ésimo menor a_i + b_j (ou, em geral, de uma matriz n x m com
+   linhas e colunas não decrescentes) sem materializar os n·m valores.
+   A matriz é dada por uma função entrada(ctx, i, j). Fazemos busca
+   binária no VALOR: contar quantas entradas são <= v custa O(n + m)
+   com a "escada" (da linha 0 para baixo, a coluna limite só diminui).
+   Total O((n + m) · log(intervalo de valores)) e memória O(1).
+*/
+
+typedef long long (*EntradaMatriz)(const void *ctx, int i, int j);
+
+// Quantas entradas são <= v (linhas e colunas não decrescentes).
+static long long contarAteValor(int n, int m, EntradaMatriz entrada, const void *ctx, long long v) {
+    long long total = 0;
+    int j = m - 1;
+    for (int i = 0; i < n && j >= 0; i++) {
+        while (j >= 0 && entrada(ctx, i, j) > v) j--;
+        total += j + 1;
+    }
+    return total;
+}
+
+/*
+ * kesimoMatrizMonotona(n, m, entrada, ctx, k, topK):
+ * - Matriz implícita n x m com linhas e colunas não decrescentes
+ *   (valores com módulo < 2^62).
+ * - Retorna a k-ésima menor entrada (1-based), ou LLONG_MAX se k for inválido.
+ * - Se topK != NULL, grava nele as k menores entradas, como em
+ *   kesimoEmRuns: primeiro as estritamente menores (linha a linha) e
+ *   depois cópias do resultado. Não é uma saída ordenada.
+ */
+long long kesimoMatrizMonotona(int n, int m, EntradaMatriz entrada, const void *ctx, long long k, long long topK[]) {
+    if (n <= 0 || m <= 0 || k <= 0 || k > (long long)n * m) return LLONG_MAX;
+
+    long long lo = entrada(ctx, 0, 0), hi = entrada(ctx, n - 1, m - 1);
+    while (lo < hi) {
+        long long meio = lo + (hi - lo) / 2;
+        if (contarAteValor(n, m, entrada, ctx, meio) >= k) hi = meio;
+        else lo = meio + 1;
+    }
+
+    if (topK != NULL) {
+        long long t = 0;
+        for (int i = 0; i < n; i++) {
+            int j = 0;
+            while (j < m && entrada(ctx, i, j) < lo) topK[t++] = entrada(ctx, i, j++);
+            if (j == 0) break;   // colunas crescentes: as próximas linhas também param em 0
+        }
+        while (t < k) topK[t++] = lo;
+    }
+    return lo;
+}
+
+typedef struct {
+    const int *a, *b;
+} SomasOrdenadas;
+
+static long long entradaSoma(const void *ctx, int i, int j) {
+    const SomasOrdenadas *s = (const SomasOrdenadas*)ctx;
+    return (long long)s->a[i] + s->b[j];
+}
+
+/*
+ * kesimoSomas(a, n, b, m, k, topK):
+ * - k-ésima menor soma a[i] + b[j] entre os n·m pares (1-based).
+ * - Ordena cópias de a e b (não altera as entradas): O(n + m) de memória.
+ * - topK como em kesimoMatrizMonotona. Retorna LLONG_MAX se k for inválido.
+ */
+long long kesimoSomas(const int a[], int n, const int b[], int m, long long k, long long topK[]) {
+    if (n <= 0 || m <= 0 || k <= 0 || k > (long long)n * m) return LLONG_MAX;
+    int *x = (int*)malloc((size_t)n * sizeof(int));
+    int *y = (int*)malloc((size_t)m * sizeof(int));
+    if (x == NULL || y == NULL) {
+        free(x);
+        free(y);
+        return LLONG_MAX;
+    }
+    for (int i = 0; i < n; i++) x[i] = a[i];
+    for (int j = 0; j < m; j++) y[j] = b[j];
+    ordenar(x, n);
+    ordenar(y, m);
+
+    SomasOrdenadas s = {x, y};
+    long long resultado = kesimoMatrizMonotona(n, m, entradaSoma, &s, k, topK);
+    free(x);
+    free(y);
+    return resultado;
+}
+
+/* =========================
+   Seleção sobre entrada segmentada
+   =========================
+   Os dados chegam em vários buffers não contíguos (pedaços de rede/IO).
+   Em vez de copiar tudo para um vetor único, enxergamos os segmentos
+   como um vetor "virtual" de índices 0..total-1 e particionamos no
+   próprio lugar. O Lomuto só anda para frente, então usamos cursores
+   que caminham segmento a segmento (sem busca por acesso).
+*/
+
+typedef struct {
+    int *dados;   // início do buffer
+    int tam;      // quantidade de elementos no buffer
+} Segmento;
+
+// Cursor sobre o vetor virtual: segmento atual e deslocamento dentro dele.
+typedef struct {
+    const Segmento *seg;
+    int s;
+    int off;
+} CursorSegmento;
+
+// Posiciona o cursor no índice virtual 'idx' (busca binária em 'inicio').
+static void cursorPosicionar(CursorSegmento *c, const Segmento seg[], const int inicio[],
+                             int nseg, int idx) {
+    int a = 0, b = nseg - 1;
+    while (a < b) {                      // último segmento com inicio <= idx
+        int meio = a + (b - a + 1) / 2;
+        if (inicio[meio] <= idx) a = meio;
+        else b = meio - 1;
+    }
+    while (seg[a].tam == 0) a++;         // pula segmentos vazios
+    c->seg = seg;
+    c->s = a;
+    c->off = idx - inicio[a];
+}
+
+static int *cursorElemento(const CursorSegmento *c) {
+    return &c->seg[c->s].dados[c->off];
+}
+
+static void cursorAvancar(CursorSegmento *c, int nseg) {
+    c->off++;
+    while (c->off >= c->seg[c->s].tam && c->s < nseg - 1) {
+        c->s++;
+        c->off = 0;
+    }
+}
+
+static void cursorRecuar(CursorSegmento *c) {
+    c->off--;
+    while (c->off < 0 && c->s > 0) {
+        c->s--;
+        c->off = c->seg[c->s].tam - 1;
+    }
+}
+
+/*
+ * particionarSegmentado: particionarTresVias sobre o intervalo virtual
+ * [l..r], com pivô de VALOR 'pivo': [l..*ini-1] < pivo,
+ * [*ini..*fim] == pivo, [*fim+1..r] > pivo.
+ */
+static void particionarSegmentado(const Segmento seg[], const int inicio[], int nseg,
+                                  int l, int r, int pivo, int *ini, int *fim) {
+    CursorSegmento clt, ci, cgt;
+    cursorPosicionar(&clt, seg, inicio, nseg, l);
+    cursorPosicionar(&cgt, seg, inicio, nseg, r);
+    ci = clt;
+    int lt = l, i = l, gt = r;
+    while (i <= gt) {
+        int v = *cursorElemento(&ci);
+        if (v < pivo) {
+            trocar(cursorElemento(&clt), cursorElemento(&ci));
+            cursorAvancar(&clt, nseg);
+            cursorAvancar(&ci, nseg);
+            lt++; i++;
+        } else if (v > pivo) {
+            trocar(cursorElemento(&ci), cursorElemento(&cgt));
+            cursorRecuar(&cgt);
+            gt--;
+        } else {
+            cursorAvancar(&ci, nseg);
+            i++;
+        }
+    }
+    *ini = lt;
+    *fim = gt;
+}
+
+/*
+ * kesimoSegmentado(seg, nseg, k):
+ * - Retorna o k-ésimo menor (1-based) entre todos os elementos dos
+ *   segmentos, como se estivessem concatenados.
+ * - Reorganiza os elementos ENTRE os segmentos (no lugar); a única
+ *   memória extra é o vetor de inícios (nseg + 1 inteiros).
+ * - Pivô aleatório => O(n) esperado.
+ * - Retorna INT_MAX se k for inválido ou faltar memória.
+ */
+int kesimoSegmentado(Segmento seg[], int nseg, int k) {
+    if (nseg <= 0) return INT_MAX;
+
+    int *inicio = (int*)malloc(((size_t)nseg + 1) * sizeof(int));
+    if (inicio == NULL) return INT_MAX;
+    inicio[0] = 0;
+    for (int s = 0; s < nseg; s++) inicio[s + 1] = inicio[s] + seg[s].tam;
+    int total = inicio[nseg];
+    if (k <= 0 || k > total) {
+        free(inicio);
+        return INT_MAX;
+    }
+
+    // O laço termina quando k cai na faixa igual ao pivô (com chaves
+    // repetidas, a faixa inteira sai de uma vez).
+    int l = 0, r = total - 1;
+    int resultado;
+    for (;;) {
+        CursorSegmento c;
+        cursorPosicionar(&c, seg, inicio, nseg, l + aleatorioAte(r - l + 1));
+        int pivo = *cursorElemento(&c), ini, fim;
+        particionarSegmentado(seg, inicio, nseg, l, r, pivo, &ini, &fim);
+        if (k - 1 < ini - l) {
+            r = ini - 1;
+        } else if (k - 1 <= fim - l) {
+            resultado = pivo;
+            break;
+        } else {
+            k -= fim - l + 1;
+            l = fim + 1;
+        }
+    }
+
+    free(inicio);
+    return resultado;
+}
+
+/* =========================
+   Seleção aproximada (sublinear)
+   =========================
+   Para painéis basta o k-ésimo com erro de ±eps·n posições. Sorteamos
+   uma amostra de s = ceil(ln(2/delta) / (2·eps²)) elementos, aplicamos
+   kesimoMinimo na amostra e devolvemos o quantil correspondente.
+   Pela desigualdade DKW, com probabilidade >= 1 - delta o posto real
+   do resultado fica a no máximo eps·n de k. O custo não depende de n.
+*/
+
+typedef struct {
+    int valor;       // elemento devolvido
+    int erroPosto;   // cota de erro prometida: ceil(eps * n) posições
+    int amostra;     // tamanho da amostra usada (n se a seleção foi exata)
+    int verificado;  // 1 se a contagem confirmou |posto - k| <= erroPosto
+    int postoMin;    // com verificação: postos 1-based ocupados por 'valor'
+    int postoMax;    //   (ficam 0 quando não há verificação)
+} ResultadoAproximado;
+
+/*
+ * kesimoAproximado(arr, n, k, eps, delta, passo, verificar):
+ * - Não altera arr: a amostra é copiada para um buffer próprio.
+ * - passo == 0: amostragem uniforme com reposição (vale a garantia).
+ * - passo != 0: amostragem em passo fixo n/s a partir de um deslocamento
+ *   aleatório. Os acessos ficam regulares (fáceis de vetorizar e de
+ *   pré-buscar), mas a garantia só vale se a ordem de arr não tiver
+ *   relação com os valores.
+ * - verificar != 0: uma passada de contagem mede o posto real do valor.
+ * - Se s >= n, faz a seleção exata sobre uma cópia.
+ * - Entrada inválida ou falta de memória: valor = INT_MAX.
+ */
+ResultadoAproximado kesimoAproximado(const int arr[], int n, int k, double eps, double delta,
+                                     int passo, int verificar) {
+    ResultadoAproximado res = {INT_MAX, 0, 0, 0, 0, 0};
+    if (n <= 0 || k <= 0 || k > n || eps <= 0.0 || delta <= 0.0 || delta >= 1.0) return res;
+
+    double tamAmostra = ceil(log(2.0 / delta) / (2.0 * eps * eps));
+    int s = tamAmostra >= n ? n : (int)tamAmostra;
+    int *amostra = (int*)malloc((size_t)s * sizeof(int));
+    if (amostra == NULL) return res;
+    int kAmostra;
+
+    if (s == n) {
+        for (int i = 0; i < n; i++) amostra[i] = arr[i];
+        kAmostra = k;
+        res.erroPosto = 0;
+    } else {
+        if (passo) {
+            // cada posição é calculada direto (somar 'salto' s vezes acumula
+            // erro de arredondamento) e limitada a n - 1
+            double salto = (double)n / s;
+            double inicio = salto * ((double)aleatorioAte(1 << 20) / (1 << 20));
+            for (int i = 0; i < s; i++) {
+                int pos = (int)(inicio + (double)i * salto);
+                amostra[i] = arr[pos < n ? pos : n - 1];
+            }
+        } else {
+            for (int i = 0; i < s; i++) amostra[i] = arr[aleatorioAte(n)];
+        }
+        kAmostra = (int)ceil((double)k * s / n);
+        if (kAmostra < 1) kAmostra = 1;
+        if (kAmostra > s) kAmostra = s;
+        res.erroPosto = (int)ceil(eps * n);
+    }
+
+    res.valor = kesimoMinimo(amostra, 0, s - 1, kAmostra);
+    res.amostra = s;
+    free(amostra);
+
+    if (verificar) {
+        int menores = 0, iguais = 0;
+        for (int i = 0; i < n; i++) {
+            menores += arr[i] < res.valor;
+            iguais += arr[i] == res.valor;
+        }
+        res.postoMin = menores + 1;
+        res.postoMax = menores + iguais;
+        // distância de k até o intervalo [postoMin, postoMax]
+        int dist = k < res.postoMin ? res.postoMin - k : (k > res.postoMax ? k - res.postoMax : 0);
+        res.verificado = dist <= res.erroPosto;
+    }
+    return res;
+}
+
+/* =========================
+   Estatísticas de ordem por linha / coluna
+   =========================
+   Matrizes no layout int** (como alocarMatriz em strassen.c). Uma
+   VisaoMatriz enxerga um retângulo da matriz sem copiá-lo, por exemplo
+   um quadrante de C.
+*/
+
+typedef struct {
+    int **linhas;        // ponteiros de linha da matriz inteira
+    int lin0, col0;      // canto superior esquerdo da visão
+    int nLinhas, nColunas;
+} VisaoMatriz;
+
+#define LINHAS_POR_TAREFA 16
+#define COLUNAS_POR_BLOCO 16   // 16 ints = 64 bytes: uma linha de cache por leitura
+
+typedef struct {
+    VisaoMatriz v;
+    int k;
+    int *saida;
+    atomic_int falhou;   // alguma tarefa ficou sem memória
+} SelecaoEixo;
+
+// kesimoMinimo também devolve INT_MAX quando falta memória para as
+// medianas (vetores com mais de 5·MEDIANAS_NA_PILHA elementos). Nesse
+// caso conta se o k-ésimo de v[0..n-1] é mesmo INT_MAX e, se não for,
+// marca a falha.
+static int selecionarConferindo(SelecaoEixo *s, int v[], int n) {
+    int valor = kesimoMinimo(v, 0, n - 1, s->k);
+    if (valor == INT_MAX) {
+        int menores = 0;
+        for (int i = 0; i < n; i++) menores += v[i] < INT_MAX;
+        if (menores >= s->k) atomic_store(&s->falhou, 1);
+    }
+    return valor;
+}
+
+static void selecionarLinhas(void *ctx, int tarefa) {
+    SelecaoEixo *s = (SelecaoEixo*)ctx;
+    int ini = tarefa * LINHAS_POR_TAREFA;
+    int fim = ini + LINHAS_POR_TAREFA < s->v.nLinhas ? ini + LINHAS_POR_TAREFA : s->v.nLinhas;
+    for (int i = ini; i < fim; i++)
+        s->saida[i] = selecionarConferindo(s, s->v.linhas[s->v.lin0 + i] + s->v.col0, s->v.nColunas);
+}
+
+static void selecionarBlocoColunas(void *ctx, int tarefa) {
+    SelecaoEixo *s = (SelecaoEixo*)ctx;
+    int c0 = tarefa * COLUNAS_POR_BLOCO;
+    int largura = c0 + COLUNAS_POR_BLOCO < s->v.nColunas ? COLUNAS_POR_BLOCO : s->v.nColunas - c0;
+    int n = s->v.nLinhas;
+    int *bloco = (int*)malloc((size_t)n * largura * sizeof(int));
+    if (bloco == NULL) {
+        atomic_store(&s->falhou, 1);
+        return;
+    }
+
+    if (n <= LIMITE_REDE) {
+        // Layout [linha][coluna] já é o layout transposto de kesimoRedeLote.
+        for (int i = 0; i < n; i++) {
+            const int *origem = s->v.linhas[s->v.lin0 + i] + s->v.col0 + c0;
+            for (int j = 0; j < largura; j++) bloco[i * largura + j] = origem[j];
+        }
+        kesimoRedeLote(bloco, n, s->k, largura, s->saida + c0);
+    } else {
+        // Transpõe o bloco: cada coluna vira um vetor contíguo.
+        for (int i = 0; i < n; i++) {
+            const int *origem = s->v.linhas[s->v.lin0 + i] + s->v.col0 + c0;
+            for (int j = 0; j < largura; j++) bloco[(size_t)j * n + i] = origem[j];
+        }
+        for (int j = 0; j < largura; j++)
+            s->saida[c0 + j] = selecionarConferindo(s, bloco + (size_t)j * n, n);
+    }
+    free(bloco);
+}
+
+/*
+ * kesimoPorLinha(v, k, saida, nThreads):
+ * - saida[i] = k-ésimo menor (1-based) da linha i da visão.
+ * - Seleciona direto em cada linha, sem cópia: os elementos de cada
+ *   linha (dentro da visão) são reorganizados, como em kesimoMinimo.
+ * - Retorna 0 em caso de sucesso e -1 se k for inválido ou faltar
+ *   memória em alguma linha longa (o resultado dela fica INT_MAX).
+ */
+int kesimoPorLinha(VisaoMatriz v, int k, int saida[], int nThreads) {
+    if (v.nLinhas <= 0 || k <= 0 || k > v.nColunas) return -1;
+    inicializarRedesSelecao();
+    SelecaoEixo s = {.v = v, .k = k, .saida = saida};
+    atomic_init(&s.falhou, 0);
+    executarEmParalelo((v.nLinhas + LINHAS_POR_TAREFA - 1) / LINHAS_POR_TAREFA, nThreads,
+                       selecionarLinhas, &s);
+    return atomic_load(&s.falhou) ? -1 : 0;
+}
+
+/*
+ * kesimoPorColuna(v, k, saida, nThreads):
+ * - saida[j] = k-ésimo menor (1-based) da coluna j da visão.
+ * - Não altera a matriz. Cada tarefa lê um bloco de COLUNAS_POR_BLOCO
+ *   colunas linha a linha (acessos contíguos) e o transpõe num buffer
+ *   próprio. Colunas com até LIMITE_REDE elementos são resolvidas todas
+ *   de uma vez com kesimoRedeLote.
+ * - Retorna 0 em caso de sucesso e -1 se k for inválido ou faltar
+ *   memória para algum bloco (as colunas desse bloco ficam sem resultado).
+ */
+int kesimoPorColuna(VisaoMatriz v, int k, int saida[], int nThreads) {
+    if (v.nColunas <= 0 || k <= 0 || k > v.nLinhas) return -1;
+    inicializarRedesSelecao();
+    SelecaoEixo s = {.v = v, .k = k, .saida = saida};
+    atomic_init(&s.falhou, 0);
+    executarEmParalelo((v.nColunas + COLUNAS_POR_BLOCO - 1) / COLUNAS_POR_BLOCO, nThreads,
+                       selecionarBlocoColunas, &s);
+    return atomic_load(&s.falhou) ? -1 : 0;
+}
+
+/* =========================
+   Mapa de zonas (min/max por bloco)
+   =========================
+   Para colunas grandes e parcialmente agrupadas (métricas em ordem de
+   tempo), muitos blocos ficam inteiros abaixo ou acima do pivô. O mapa
+   guarda, para cada bloco de BLOCO_ZONA valores, o mínimo e o máximo
+   (e, opcionalmente, um histograma de FAIXAS_ZONA faixas iguais entre
+   eles). A seleção então:
+   - conta blocos inteiros pelo min/max, sem tocar nos dados;
+   - particiona (em três vias) só os blocos que cruzam o pivô, e só
+     dentro do próprio bloco: min, max e histograma continuam valendo;
+   - com histogramas, escolhe o pivô onde eles estimam o k-ésimo.
+   O mapa é mantido a cada anexação (só o último bloco e os novos são
+   recalculados).
+*/
+
+#define BLOCO_ZONA 4096
+#define FAIXAS_ZONA 8
+
+typedef struct {
+    int *dados;
+    long n, capacidade;
+    long nBlocos, capBlocos;
+    int *minimo, *maximo;              // por bloco
+    int comHistogramas;
+    unsigned short *histogramas;       // FAIXAS_ZONA por bloco
+} MapaZonas;
+
+// Prepara um mapa vazio (com ou sem histogramas por bloco).
+void mapaZonasCriar(MapaZonas *m, int comHistogramas) {
+    m->dados = NULL;
+    m->n = m->capacidade = 0;
+    m->nBlocos = m->capBlocos = 0;
+    m->minimo = m->maximo = NULL;
+    m->comHistogramas = comHistogramas;
+    m->histogramas = NULL;
+}
+
+void mapaZonasLiberar(MapaZonas *m) {
+    free(m->dados);
+    free(m->minimo);
+    free(m->maximo);
+    free(m->histogramas);
+    mapaZonasCriar(m, m->comHistogramas);
+}
+
+static long tamBlocoZona(const MapaZonas *m, long b) {
+    long fim = (b + 1) * BLOCO_ZONA < m->n ? (b + 1) * BLOCO_ZONA : m->n;
+    return fim - b * BLOCO_ZONA;
+}
+
+// Largura das faixas do bloco b (faixas iguais entre mínimo e máximo).
+static long long larguraFaixaZona(const MapaZonas *m, long b) {
+    return ((long long)m->maximo[b] - m->minimo[b]) / FAIXAS_ZONA + 1;
+}
+
+// Recalcula min, max e histograma do bloco b a partir dos dados.
+static void recalcularBlocoZona(MapaZonas *m, long b) {
+    const int *v = m->dados + b * BLOCO_ZONA;
+    long tam = tamBlocoZona(m, b);
+    int mn = v[0], mx = v[0];
+    for (long i = 1; i < tam; i++) {
+        if (v[i] < mn) mn = v[i];
+        if (v[i] > mx) mx = v[i];
+    }
+    m->minimo[b] = mn;
+    m->maximo[b] = mx;
+    if (m->comHistogramas) {
+        unsigned short *h = m->histogramas + b * FAIXAS_ZONA;
+        long long largura = larguraFaixaZona(m, b);
+        for (int f = 0; f < FAIXAS_ZONA; f++) h[f] = 0;
+        for (long i = 0; i < tam; i++) h[((long long)v[i] - mn) / largura]++;
+    }
+}
+
+/*
+ * mapaZonasAnexar(m, valores, qtd): acrescenta qtd valores ao fim da
+ * coluna e atualiza o mapa. Retorna 0, ou -1 se faltar memória (nesse
+ * caso nada é anexado).
+ */
+int mapaZonasAnexar(MapaZonas *m, const int valores[], long qtd) {
+    if (qtd <= 0) return 0;
+    long n = m->n + qtd;
+    long nBlocos = (n + BLOCO_ZONA - 1) / BLOCO_ZONA;
+
+    if (n > m->capacidade) {
+        long cap = m->capacidade ? m->capacidade : BLOCO_ZONA;
+        while (cap < n) cap *= 2;
+        int *dados = (int*)realloc(m->dados, (size_t)cap * sizeof(int));
+        if (dados == NULL) return -1;
+        m->dados = dados;
+        m->capacidade = cap;
+    }
+    if (nBlocos > m->capBlocos) {
+        long cap = m->capBlocos ? m->capBlocos : 16;
+        while (cap < nBlocos) cap *= 2;
+        int *mn = (int*)realloc(m->minimo, (size_t)cap * sizeof(int));
+        if (mn == NULL) return -1;
+        m->minimo = mn;
+        int *mx = (int*)realloc(m->maximo, (size_t)cap * sizeof(int));
+        if (mx == NULL) return -1;
+        m->maximo = mx;
+        if (m->comHistogramas) {
+            unsigned short *h = (unsigned short*)realloc(m->histogramas,
+                                                         (size_t)cap * FAIXAS_ZONA * sizeof(unsigned short));
+            if (h == NULL) return -1;
+            m->histogramas = h;
+        }
+        m->capBlocos = cap;
+    }
+
+    long primeiro = m->n / BLOCO_ZONA;   // último bloco (incompleto) ou o primeiro novo
+    for (long i = 0; i < qtd; i++) m->dados[m->n + i] = valores[i];
+    m->n = n;
+    m->nBlocos = nBlocos;
+    for (long b = primeiro; b < nBlocos; b++) recalcularBlocoZona(m, b);
+    return 0;
+}
+
+// Quantos valores da coluna são < x (blocos inteiros contados pelo min/max).
+long mapaZonasPosto(const MapaZonas *m, int x) {
+    long menores = 0;
+    for (long b = 0; b < m->nBlocos; b++) {
+        if (m->maximo[b] < x) {
+            menores += tamBlocoZona(m, b);
+        } else if (m->minimo[b] < x) {
+            const int *v = m->dados + b * BLOCO_ZONA;
+            long tam = tamBlocoZona(m, b);
+            for (long i = 0; i < tam; i++) menores += v[i] < x;
+        }
+    }
+    return menores;
+}
+
+// Massa do histograma do bloco b em [x, y] (interpolando dentro das faixas).
+static double massaHistogramaZona(const MapaZonas *m, long b, long long x, long long y) {
+    const unsigned short *h = m->histogramas + b * FAIXAS_ZONA;
+    long long largura = larguraFaixaZona(m, b);
+    double massa = 0.0;
+    for (int f = 0; f < FAIXAS_ZONA; f++) {
+        long long ini = m->minimo[b] + f * largura, fim = ini + largura - 1;
+        long long a = x > ini ? x : ini, c = y < fim ? y : fim;
+        if (a <= c) massa += h[f] * (double)(c - a + 1) / largura;
+    }
+    return massa;
+}
+
+/*
+ * Estimativa pelos histogramas: menor valor v em [lo, hi] com pelo
+ * menos k elementos ativos estimados <= v. Cada bloco contribui com
+ * seus 'ativos' proporcionalmente à massa do histograma na janela.
+ */
+static int pivoPorHistogramasZona(const MapaZonas *m, const int ini[], const int fim[],
+                                  long long lo, long long hi, long k) {
+    long long a = lo, c = hi;   // busca binária em [a, c]; a janela [lo, hi] fica fixa
+    while (a < c) {
+        long long meio = a + (c - a) / 2;
+        double estimados = 0.0;
+        for (long b = 0; b < m->nBlocos; b++) {
+            int ativos = fim[b] - ini[b];
+            if (ativos == 0) continue;
+            long long L = m->minimo[b] > lo ? m->minimo[b] : lo;
+            long long H = m->maximo[b] < hi ? m->maximo[b] : hi;
+            if (meio < L) continue;
+            if (meio >= H) { estimados += ativos; continue; }
+            double total = massaHistogramaZona(m, b, L, H);
+            if (total > 0.0) estimados += ativos * massaHistogramaZona(m, b, L, meio) / total;
+        }
+        if (estimados >= k) c = meio;
+        else a = meio + 1;
+    }
+    return (int)a;
+}
+
+// Valor de um elemento ativo sorteado, percorrendo os blocos.
+static int sortearAtivoZona(const MapaZonas *m, const int ini[], const int fim[], long ativos) {
+    long j = (long)((((unsigned long)aleatorioAte(1 << 30) << 30) | (unsigned long)aleatorioAte(1 << 30))
+                    % (unsigned long)ativos);
+    long b = 0;
+    while (j >= fim[b] - ini[b]) {
+        j -= fim[b] - ini[b];
+        b++;
+    }
+    return m->dados[b * BLOCO_ZONA + ini[b] + j];
+}
+
+/*
+ * kesimoZonas(m, k): k-ésimo menor (1-based) da coluna do mapa.
+ * - Reordena valores só dentro dos blocos que cruzam algum pivô; o
+ *   mapa continua válido.
+ * - Retorna INT_MAX se k for inválido ou faltar memória.
+ */
+int kesimoZonas(MapaZonas *m, long k) {
+    if (k <= 0 || k > m->n) return INT_MAX;
+    // Faixa ativa de cada bloco (relativa ao início do bloco) e onde o pivô a cortou
+    int *ini = (int*)malloc((size_t)m->nBlocos * 4 * sizeof(int));
+    if (ini == NULL) return INT_MAX;
+    int *fim = ini + m->nBlocos, *corteMenor = fim + m->nBlocos, *corteMaior = corteMenor + m->nBlocos;
+    for (long b = 0; b < m->nBlocos; b++) {
+        ini[b] = 0;
+        fim[b] = (int)tamBlocoZona(m, b);
+    }
+
+    long long lo = INT_MIN, hi = INT_MAX;   // todo ativo está em [lo, hi]
+    long ativos = m->n;
+    int usarHistograma = m->comHistogramas;
+    int resultado = INT_MAX;
+
+    for (;;) {
+        // Poucos ativos: junta e resolve direto
+        if (ativos <= BLOCO_ZONA) {
+            int *buffer = (int*)malloc((size_t)ativos * sizeof(int));
+            if (buffer != NULL) {
+                long t = 0;
+                for (long b = 0; b < m->nBlocos; b++)
+                    for (int i = ini[b]; i < fim[b]; i++) buffer[t++] = m->dados[b * BLOCO_ZONA + i];
+                resultado = kesimoRapido(buffer, 0, (int)ativos - 1, (int)k);
+                free(buffer);
+            }
+            break;
+        }
+
+        int pivo;
+        if (usarHistograma) {
+            // Mira um pouco além do k-ésimo, do lado que tem mais elementos:
+            // a margem absorve o erro da estimativa e o lado que sobra é o
+            // pequeno (duas rodadas cercam o k-ésimo, como em Floyd-Rivest).
+            long margem = ativos / 16 + 1;
+            long alvo = k <= ativos / 2 ? k + margem : k - margem;
+            if (alvo < 1) alvo = 1;
+            pivo = pivoPorHistogramasZona(m, ini, fim, lo, hi, alvo);
+        } else {
+            int amostra[3];
+            for (int s = 0; s < 3; s++) amostra[s] = sortearAtivoZona(m, ini, fim, ativos);
+            pivo = amostra[indiceMediana3(amostra, 0, 1, 2)];
+        }
+
+        // Conta pelo min/max (limitado a [lo, hi]); particiona só quem cruza o pivô
+        long menores = 0, iguais = 0;
+        for (long b = 0; b < m->nBlocos; b++) {
+            if (ini[b] == fim[b]) {
+                corteMenor[b] = corteMaior[b] = ini[b];
+                continue;
+            }
+            long long L = m->minimo[b] > lo ? m->minimo[b] : lo;
+            long long H = m->maximo[b] < hi ? m->maximo[b] : hi;
+            if (H < pivo) {
+                corteMenor[b] = corteMaior[b] = fim[b];
+            } else if (L > pivo) {
+                corteMenor[b] = corteMaior[b] = ini[b];
+            } else if (L == H) {
+                corteMenor[b] = ini[b];
+                corteMaior[b] = fim[b];
+            } else {
+                int a, c;
+                int *v = m->dados + b * BLOCO_ZONA;
+                particionarTresVias(v, ini[b], fim[b] - 1, pivo, &a, &c);
+                corteMenor[b] = a;
+                corteMaior[b] = c + 1;
+            }
+            menores += corteMenor[b] - ini[b];
+            iguais += corteMaior[b] - corteMenor[b];
+        }
+
+        long antes = ativos;
+        if (k <= menores) {
+            for (long b = 0; b < m->nBlocos; b++) fim[b] = corteMenor[b];
+            hi = (long long)pivo - 1;
+            ativos = menores;
+        } else if (k <= menores + iguais) {
+            resultado = pivo;
+            break;
+        } else {
+            for (long b = 0; b < m->nBlocos; b++) ini[b] = corteMaior[b];
+            lo = (long long)pivo + 1;
+            k -= menores + iguais;
+            ativos -= menores + iguais;
+        }
+        // A estimativa só vale enquanto elimina bem; senão, pivô aleatório
+        usarHistograma = m->comHistogramas && ativos <= antes * 3 / 4;
+    }
+
+    free(ini);
+    return resultado;
+}
+
+/* =========================
+   Seleção lexicográfica por colunas
+   =========================
+   Registros guardados por coluna (ex.: tenant[], timestamp[], id[]) e
+   ordenados pela chave composta (coluna 0, coluna 1, ...). Em vez de
+   montar uma chave única, refina coluna a coluna sobre uma permutação
+   dos registros:
+   - copia a coluna c dos registros ativos para um vetor contíguo;
+   - acha o k-ésimo valor v dessa coluna com kesimoRapido;
+   - particiona (chave, registro) em três vias em torno de v.
+   O k-ésimo registro está na faixa dos iguais a v; só ela segue para a
+   coluna seguinte, então as colunas de trás costumam ver poucos registros.
+*/
+
+/*
+ * kesimoLexicografico(colunas, nColunas, n, k):
+ * - colunas[c][i] é o valor da coluna c no registro i (0 <= i < n).
+ * - Retorna o índice do registro que fica na posição k (1-based) na
+ *   ordem lexicográfica das colunas; entre registros com todas as
+ *   colunas iguais, qualquer um deles.
+ * - Não altera as colunas. Retorna -1 para parâmetros inválidos.
+ */
+int kesimoLexicografico(const int *colunas[], int nColunas, int n, int k) {
+    if (nColunas <= 0 || n <= 0 || k <= 0 || k > n) return -1;
+    int *perm = (int*)malloc((size_t)n * sizeof(int));
+    int *chaves = (int*)malloc((size_t)n * sizeof(int));
+    int *copia = (int*)malloc((size_t)n * sizeof(int));
+    if (perm == NULL || chaves == NULL || copia == NULL) {
+        free(perm); free(chaves); free(copia);
+        return -1;
+    }
+    for (int i = 0; i < n; i++) perm[i] = i;
+
+    // Registros ativos: perm[l..r]; k é relativo a l
+    int l = 0, r = n - 1;
+    for (int c = 0; c < nColunas && l < r; c++) {
+        const int *coluna = colunas[c];
+        for (int i = l; i <= r; i++) chaves[i] = copia[i] = coluna[perm[i]];
+        int v = kesimoRapido(copia, l, r, k);
+
+        // três vias sobre os pares (chaves[i], perm[i])
+        int lt = l, i = l, gt = r;
+        while (i <= gt) {
+            if (chaves[i] < v) {
+                trocar(&chaves[lt], &chaves[i]);
+                trocar(&perm[lt++], &perm[i++]);
+            } else if (chaves[i] > v) {
+                trocar(&chaves[i], &chaves[gt]);
+                trocar(&perm[i], &perm[gt--]);
+            } else {
+                i++;
+            }
+        }
+        k -= lt - l;
+        l = lt;
+        r = gt;
+    }
+
+    int registro = perm[l + k - 1];
+    free(perm);
+    free(chaves);
+    free(copia);
+    return registro;
+}
+
+/* =========================
+   Estatísticas robustas
+   =========================
+   Mediana, quartis, IQR, MAD e média aparada numa chamada só.
+   - Um quickselect de vários postos (selecionarPostos) coloca na posição
+     certa, de uma vez, os postos da mediana, dos quartis e dos cortes da
+     média aparada: cada partição serve a todos os postos que caem nela.
+   - Com os cortes no lugar, a média aparada é a soma de um trecho
+     contíguo do vetor.
+   - MAD: pelo menos metade dos valores está em [q1, q3], então
+     MAD <= D = max(mediana - q1, q3 - mediana). Só os desvios <= D são
+     copiados (os outros ficam todos acima do MAD e não mudam o posto
+     procurado). Desvios vão até 2^32 - 1: são guardados como unsigned
+     com o bit de sinal invertido (x ^ 0x80000000), o que os leva para int
+     sem mudar a ordem, e selecionados com kesimoRapido.
+   Convenções: mediana inferior (posto (n+1)/2), quartis pelo posto mais
+   próximo (ceil(n/4) e ceil(3n/4)), MAD = mediana inferior dos desvios.
+*/
+
+typedef struct {
+    int mediana;
+    int q1, q3;
+    unsigned intervaloQuartis;   // q3 - q1
+    unsigned mad;                // mediana de |x - mediana|
+    double mediaAparada;
+} EstatisticasRobustas;
+
+/*
+ * Coloca em arr[p - 1] o p-ésimo menor de arr[l..r] para cada p de
+ * postos[0..nPostos-1] (crescentes, 1-based e relativos a arr[0]).
+ * Estoura o orçamento (pivôs ruins) => ordena o trecho.
+ */
+static void selecionarPostos(int arr[], int l, int r, const int postos[], int nPostos, long long orcamento) {
+    while (nPostos > 0 && r - l + 1 > LIMITE_REDE) {
+        int n = r - l + 1;
+        if (orcamento < 0) {
+            ordenar(arr + l, n);
+            return;
+        }
+        orcamento -= n;
+
+        int meio = l + n / 2, s = n / 8;
+        int p = indiceMediana3(arr,
+                               indiceMediana3(arr, l, l + s, l + 2 * s),
+                               indiceMediana3(arr, meio - s, meio, meio + s),
+                               indiceMediana3(arr, r - 2 * s, r - s, r));
+        int ini, fim;
+        particionarTresVias(arr, l, r, arr[p], &ini, &fim);
+
+        // postos à esquerda (< ini+1), na faixa do pivô (prontos) e à direita
+        int a = 0;
+        while (a < nPostos && postos[a] - 1 < ini) a++;
+        int b = a;
+        while (b < nPostos && postos[b] - 1 <= fim) b++;
+        if (a > 0) selecionarPostos(arr, l, ini - 1, postos, a, orcamento);
+        l = fim + 1;
+        postos += b;
+        nPostos -= b;
+    }
+    if (nPostos > 0) insertionSort(arr + l, r - l + 1);
+}
+
+/*
+ * estatisticasRobustas(arr, n, corte, saida):
+ * - mediaAparada descarta floor(corte * n) valores de cada ponta
+ *   (0 <= corte < 0.5).
+ * - 'arr' é reorganizado (como em kesimoMinimo); usa um buffer de n ints.
+ * - Retorna 0 em caso de sucesso e -1 para parâmetros inválidos ou falta
+ *   de memória.
+ */
+int estatisticasRobustas(int arr[], int n, double corte, EstatisticasRobustas *saida) {
+    if (n <= 0 || !(corte >= 0 && corte < 0.5) || saida == NULL) return -1;
+    unsigned *desvios = (unsigned*)malloc((size_t)n * sizeof(unsigned));
+    if (desvios == NULL) return -1;
+
+    int apara = (int)(corte * n);
+    int kMed = n / 2 + n % 2;
+    int kQ1 = (int)(((long long)n + 3) / 4), kQ3 = (int)((3LL * n + 3) / 4);
+
+    // postos pedidos, em ordem e sem repetição
+    int candidatos[5] = {apara + 1, kQ1, kMed, kQ3, n - apara}, postos[5], nPostos = 0;
+    for (int i = 1; i < 5; i++)
+        for (int j = i; j > 0 && candidatos[j - 1] > candidatos[j]; j--) trocar(&candidatos[j - 1], &candidatos[j]);
+    for (int i = 0; i < 5; i++)
+        if (nPostos == 0 || postos[nPostos - 1] != candidatos[i]) postos[nPostos++] = candidatos[i];
+    selecionarPostos(arr, 0, n - 1, postos, nPostos, 4LL * n);
+
+    int med = arr[kMed - 1];
+    saida->mediana = med;
+    saida->q1 = arr[kQ1 - 1];
+    saida->q3 = arr[kQ3 - 1];
+    saida->intervaloQuartis = (unsigned)saida->q3 - (unsigned)saida->q1;
+
+    long long soma = 0;
+    for (int i = apara; i < n - apara; i++) soma += arr[i];
+    saida->mediaAparada = (double)soma / (n - 2 * apara);
+
+    // MAD: só os desvios dentro da faixa [mediana - D, mediana + D]
+    unsigned abaixo = (unsigned)med - (unsigned)saida->q1, acima = (unsigned)saida->q3 - (unsigned)med;
+    unsigned D = abaixo > acima ? abaixo : acima;
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        unsigned d = arr[i] >= med ? (unsigned)arr[i] - (unsigned)med : (unsigned)med - (unsigned)arr[i];
+        desvios[m] = d ^ 0x80000000u;
+        m += d <= D;
+    }
+    int *chaves = (int*)desvios;
+    saida->mad = (unsigned)kesimoRapido(chaves, 0, m - 1, kMed) ^ 0x80000000u;
+
+    free(desvios);
+    return 0;
+}
+
+/* =========================
+   Demonstração de uso
+   =========================
+   Outros programas podem reaproveitar estas funções com
+   #define KESIMO_SEM_MAIN antes de #include "kesimo.c".
+*/
+#ifndef KESIMO_SEM_MAIN
+int main() {
+    int D[] = {25, 21, 98, 100, 76, 22, 43, 60, 89, 42};
+    int n = sizeof(D) / sizeof(D[0]);
+    int k = 5; // queremos o 5º menor (k é 1-based)
+
+    printf("Array original: ");
+    for(int i = 0; i < n; i++) printf("%d ", D[i]);
+    printf("\n");
+
+    // Para referência, array ordenado seria:
+    // 21, 22, 25, 42, 43, 60, 76, 89, 98, 100
+    // O 5º menor é 43.
+
+    int resultado = kesimoMinimo(D, 0, n - 1, k);
+
+    if (resultado != INT_MAX) {
+        printf("O %d-esimo menor elemento e: %d\n", k, resultado);
+    } else {
+        printf("k e invalido.\n");
+    }
+
+    // Ordenação com as mesmas peças da seleção
+    ordenar(D, n);
+    printf("Array ordenado: ");
+    for (int i = 0; i < n; i++) printf("%d ", D[i]);
+    printf("\n");
+
+    // Mediana ponderada: a chave 60 concentra quase metade do peso total.
+    int chaves[] = {25, 21, 98, 60, 43};
+    double pesos[] = {1.0, 1.0, 1.0, 3.0, 0.5};
+    printf("Mediana ponderada: %d\n", kesimoPonderado(chaves, pesos, 5, 0.5)); // 60
+
+    // Os mesmos 10 valores, mas chegando em 3 runs já ordenados.
+    int run0[] = {21, 43, 98}, run1[] = {22, 25, 60, 100}, run2[] = {42, 76, 89};
+    int *runs[] = {run0, run1, run2};
+    int tamRuns[] = {3, 4, 3};
+    printf("5o menor entre os runs: %d\n", kesimoEmRuns(runs, tamRuns, 3, 5, NULL)); // 43
+
+    // X + Y: 4o menor entre as 12 somas, sem montar as somas
+    int X[] = {10, 1, 5}, Y[] = {3, 0, 20, 7};
+    long long menoresSomas[4];
+    printf("4a menor soma X+Y: %lld\n", kesimoSomas(X, 3, Y, 4, 4, menoresSomas)); // 8 (1, 4, 5, 8)
+
+    // Os mesmos valores espalhados em dois buffers não contíguos.
+    int pedaco0[] = {25, 21, 98, 100}, pedaco1[] = {76, 22, 43, 60, 89, 42};
+    Segmento segs[] = {{pedaco0, 4}, {pedaco1, 6}};
+    printf("5o menor entre os segmentos: %d\n", kesimoSegmentado(segs, 2, 5)); // 43
+
+    // Aproximado: com n tão pequeno a amostra cobre tudo e o resultado é exato.
+    ResultadoAproximado aprox = kesimoAproximado(D, n, k, 0.05, 0.01, 0, 1);
+    printf("5o menor aproximado: %d (erro <= %d posicoes, verificado: %d)\n",
+           aprox.valor, aprox.erroPosto, aprox.verificado);
+
+    // Mediana de cada linha e de cada coluna de uma matriz 3x3
+    int l0[] = {9, 1, 5}, l1[] = {4, 8, 2}, l2[] = {7, 3, 6};
+    int *M[] = {l0, l1, l2};
+    VisaoMatriz visao = {M, 0, 0, 3, 3};
+    int medLinhas[3], medColunas[3];
+    kesimoPorColuna(visao, 2, medColunas, 1);
+    kesimoPorLinha(visao, 2, medLinhas, 1);
+    printf("Medianas das linhas: %d %d %d | das colunas: %d %d %d\n",
+           medLinhas[0], medLinhas[1], medLinhas[2],
+           medColunas[0], medColunas[1], medColunas[2]); // 5 4 6 | 7 3 5
+
+    // Lote: três medianas independentes sobre o mesmo buffer
+    int buffer[] = {5, 1, 3,   9, 7, 8, 6, 2,   4, 4, 0};
+    TarefaSelecao tarefas[] = {{0, 3, 2}, {3, 5, 3}, {8, 3, 2}};
+    int medianas[3];
+    kesimoLote(buffer, tarefas, 3, medianas, 2);
+    printf("Medianas do lote: %d %d %d\n", medianas[0], medianas[1], medianas[2]); // 3 7 4
+
+    // Incremental: passos curtos, intercalados com outro trabalho
+    int E[] = {25, 21, 98, 100, 76, 22, 43, 60, 89, 42};
+    SelecaoIncremental sel;
+    selecaoIniciar(&sel, E, 0, n - 1, k);
+    while (!selecaoPasso(&sel, 4)) {
+        // ...atende o trabalho sensível a latência aqui...
+    }
+    printf("5o menor incremental: %d\n", sel.resultado); // 43
+
+    // Mapa de zonas: série crescente com ruído, anexada em duas partes
+    MapaZonas mapa;
+    mapaZonasCriar(&mapa, 1);
+    int serie[20000];
+    for (int i = 0; i < 20000; i++) serie[i] = i + (i * 37) % 11;
+    mapaZonasAnexar(&mapa, serie, 12000);
+    mapaZonasAnexar(&mapa, serie + 12000, 8000);
+    printf("Mediana pelo mapa de zonas: %d (%ld blocos)\n", kesimoZonas(&mapa, 10000), mapa.nBlocos); // 10004
+    mapaZonasLiberar(&mapa);
+
+    // Registros (tenant, timestamp, id) por coluna: 3o menor pela chave composta
+    int tenant[] = {2, 1, 2, 1, 1}, instante[] = {50, 70, 10, 70, 30}, ident[] = {7, 9, 8, 4, 6};
+    const int *colunas[] = {tenant, instante, ident};
+    printf("3o registro em (tenant, timestamp, id): %d\n", kesimoLexicografico(colunas, 3, 5, 3)); // 1 (1, 70, 9)
+
+    // Estatísticas robustas: o 1000 quase não mexe na mediana, no MAD nem na média aparada
+    int amostras[] = {12, 15, 11, 14, 1000, 13, 12, 16, 10, 13};
+    EstatisticasRobustas er;
+    estatisticasRobustas(amostras, 10, 0.1, &er);
+    printf("Mediana %d, q1 %d, q3 %d, MAD %u, media aparada %.2f\n",
+           er.mediana, er.q1, er.q3, er.mad, er.mediaAparada); // 13, 12, 15, 1, 13.25
+
+    TRACE_SALVAR("trace_kesimo.json");
+
     return 0;
 }
+#endif
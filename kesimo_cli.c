@@ -0,0 +1,572 @@
+#define _GNU_SOURCE
+#define KESIMO_SEM_MAIN
+#include "kesimo.c"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * Ferramenta de linha de comando para consultas de percentil/k-ésimo.
+ *
+ * Compilar com: gcc -O2 -pthread kesimo_cli.c -o kesimo_cli -lm
+ *
+ * Uso: ./kesimo_cli ARQUIVO [opções] (-k K | -p P)...
+ *   --tipo i32|i64|f32|f64   tipo da coluna (padrão: i32)
+ *   --texto                  arquivo texto, um número por linha/espaço
+ *   -k K                     k-ésimo menor (1-based); pode repetir
+ *   -p P                     percentil P em [0, 100]; pode repetir
+ *   --modo auto|memoria|paralelo|externo   (padrão: auto)
+ *   --threads N              threads dos modos paralelo/externo
+ *
+ * Arquivos binários são mapeados com mmap (sem leitura para buffer).
+ * Modos:
+ *   memoria  - copia as chaves para um vetor e usa kesimoMinimo.
+ *   paralelo - não copia: passadas de histograma de 16 bits sobre o
+ *              mmap, divididas entre threads, até sobrar um punhado de
+ *              candidatos; esses são copiados e resolvidos com kesimoMinimo.
+ *   externo  - as mesmas passadas, com leitura sequencial avisada ao
+ *              kernel (madvise), para arquivos maiores que a RAM livre.
+ *   auto     - externo se o arquivo passa da metade da RAM livre;
+ *              paralelo se n >= 2^24; senão memoria.
+ */
+
+/* ===================== Coluna e chaves ===================== */
+
+typedef enum { TIPO_I32, TIPO_I64, TIPO_F32, TIPO_F64 } TipoColuna;
+
+typedef struct {
+    TipoColuna tipo;
+    const void *dados;
+    long n;
+    size_t bytes;      // tamanho mapeado/alocado
+    int mapeado;       // 1 se veio de mmap
+} Coluna;
+
+static int larguraChave(TipoColuna t) {
+    return (t == TIPO_I32 || t == TIPO_F32) ? 32 : 64;
+}
+
+/*
+ * Chave sem sinal que preserva a ordem dos valores: comparar chaves
+ * é o mesmo que comparar os valores originais (floats negativos têm
+ * todos os bits invertidos; os demais só o bit de sinal).
+ */
+static uint64_t chaveEm(const Coluna *c, long i) {
+    switch (c->tipo) {
+    case TIPO_I32:
+        return (uint32_t)((const int32_t*)c->dados)[i] ^ 0x80000000u;
+    case TIPO_I64:
+        return (uint64_t)((const int64_t*)c->dados)[i] ^ 0x8000000000000000ull;
+    case TIPO_F32: {
+        uint32_t b;
+        memcpy(&b, (const float*)c->dados + i, sizeof(b));
+        return (b & 0x80000000u) ? ~b : (b | 0x80000000u);
+    }
+    default: {
+        uint64_t b;
+        memcpy(&b, (const double*)c->dados + i, sizeof(b));
+        return (b & 0x8000000000000000ull) ? ~b : (b | 0x8000000000000000ull);
+    }
+    }
+}
+
+// Inverso de chaveEm, formatado para impressão.
+static void imprimirValor(TipoColuna tipo, uint64_t chave) {
+    switch (tipo) {
+    case TIPO_I32:
+        printf("%d", (int32_t)((uint32_t)chave ^ 0x80000000u));
+        break;
+    case TIPO_I64:
+        printf("%lld", (long long)(int64_t)(chave ^ 0x8000000000000000ull));
+        break;
+    case TIPO_F32: {
+        uint32_t b = (uint32_t)chave;
+        b = (b & 0x80000000u) ? (b & 0x7FFFFFFFu) : ~b;
+        float f;
+        memcpy(&f, &b, sizeof(f));
+        printf("%.9g", f);
+        break;
+    }
+    default: {
+        uint64_t b = (chave & 0x8000000000000000ull) ? (chave & 0x7FFFFFFFFFFFFFFFull) : ~chave;
+        double d;
+        memcpy(&d, &b, sizeof(d));
+        printf("%.17g", d);
+        break;
+    }
+    }
+}
+
+// Metade de 32 bits de uma chave como int com a mesma ordem (para kesimoMinimo).
+static int metadeComoInt(uint32_t metade) {
+    return (int)(metade ^ 0x80000000u);
+}
+
+/* ===================== Modo memória ===================== */
+
+/*
+ * selecionarEmMemoria: resolve todos os ks copiando as chaves uma vez.
+ * 32 bits: um vetor de int e kesimoMinimo direto (o vetor continua
+ * sendo uma permutação, então serve para os próximos ks).
+ * 64 bits: seleciona pela metade alta; depois, só entre os que empatam
+ * na metade alta, seleciona pela metade baixa.
+ * Retorna 0, ou -1 se faltar memória.
+ */
+static int selecionarEmMemoria(const Coluna *c, const long ks[], int nk, uint64_t saida[]) {
+    int n = (int)c->n;
+    int *altas = (int*)malloc((size_t)n * sizeof(int));
+    if (altas == NULL) return -1;
+    int largura = larguraChave(c->tipo);
+    for (int i = 0; i < n; i++) {
+        uint64_t ch = chaveEm(c, i);
+        altas[i] = metadeComoInt(largura == 32 ? (uint32_t)ch : (uint32_t)(ch >> 32));
+    }
+
+    for (int q = 0; q < nk; q++) {
+        int alta = kesimoMinimo(altas, 0, n - 1, (int)ks[q]);
+        uint32_t altaBits = (uint32_t)alta ^ 0x80000000u;
+        if (largura == 32) {
+            saida[q] = altaBits;
+            continue;
+        }
+        // segunda etapa: metade baixa entre os empatados
+        int menores = 0, empatados = 0;
+        for (int i = 0; i < n; i++) {
+            uint32_t a = (uint32_t)(chaveEm(c, i) >> 32);
+            menores += a < altaBits;
+            empatados += a == altaBits;
+        }
+        int *baixas = (int*)malloc((size_t)empatados * sizeof(int));
+        if (baixas == NULL) {
+            free(altas);
+            return -1;
+        }
+        int t = 0;
+        for (int i = 0; i < n; i++) {
+            uint64_t ch = chaveEm(c, i);
+            if ((uint32_t)(ch >> 32) == altaBits) baixas[t++] = metadeComoInt((uint32_t)ch);
+        }
+        int baixa = kesimoMinimo(baixas, 0, empatados - 1, (int)ks[q] - menores);
+        saida[q] = ((uint64_t)altaBits << 32) | ((uint32_t)baixa ^ 0x80000000u);
+        free(baixas);
+    }
+    free(altas);
+    return 0;
+}
+
+/* ===================== Modos paralelo / externo ===================== */
+
+#define DIGITOS 65536
+#define LIMITE_CANDIDATOS (1 << 20)
+
+typedef struct {
+    const Coluna *coluna;
+    int largura;
+    int bitsConhecidos;    // quantos bits do topo da chave já foram fixados
+    uint64_t prefixo;      // valor desses bits
+    int nBlocos;
+    long *histogramas;     // nBlocos x DIGITOS
+    uint64_t *candidatos;  // usado na passada de coleta
+    long *deslocamentos;   // onde cada bloco escreve seus candidatos
+    int digito;            // dígito escolhido (passada de coleta)
+} PassadaHistograma;
+
+static int prefixoConfere(const PassadaHistograma *p, uint64_t ch) {
+    return p->bitsConhecidos == 0 || (ch >> (p->largura - p->bitsConhecidos)) == p->prefixo;
+}
+
+static void blocoDoIndice(const PassadaHistograma *p, int b, long *ini, long *fim) {
+    long n = p->coluna->n;
+    *ini = n * b / p->nBlocos;
+    *fim = n * (b + 1) / p->nBlocos;
+}
+
+static void contarBloco(void *ctx, int b) {
+    PassadaHistograma *p = (PassadaHistograma*)ctx;
+    long *hist = p->histogramas + (size_t)b * DIGITOS;
+    int desloc = p->largura - p->bitsConhecidos - 16;
+    long ini, fim;
+    blocoDoIndice(p, b, &ini, &fim);
+    memset(hist, 0, DIGITOS * sizeof(long));
+    for (long i = ini; i < fim; i++) {
+        uint64_t ch = chaveEm(p->coluna, i);
+        if (prefixoConfere(p, ch)) hist[(ch >> desloc) & 0xFFFF]++;
+    }
+}
+
+static void coletarBloco(void *ctx, int b) {
+    PassadaHistograma *p = (PassadaHistograma*)ctx;
+    int desloc = p->largura - p->bitsConhecidos - 16;
+    long ini, fim, t = p->deslocamentos[b];
+    blocoDoIndice(p, b, &ini, &fim);
+    for (long i = ini; i < fim; i++) {
+        uint64_t ch = chaveEm(p->coluna, i);
+        if (prefixoConfere(p, ch) && (int)((ch >> desloc) & 0xFFFF) == p->digito)
+            p->candidatos[t++] = ch;
+    }
+}
+
+/*
+ * selecionarPorHistograma: k-ésimo sem copiar a coluna.
+ * Cada passada conta, entre os elementos que batem com o prefixo já
+ * fixado, quantos há de cada próximo dígito de 16 bits; o dígito onde
+ * a contagem acumulada cruza k entra no prefixo. Quando sobram poucos
+ * candidatos (e no máximo 32 bits a decidir), eles são copiados e
+ * resolvidos com kesimoMinimo.
+ * 'histRaiz' guarda a primeira passada, que é igual para todos os ks
+ * ('*raizPronta' diz se ela já foi calculada).
+ * Grava o k-ésimo em '*resultado' e retorna 0, ou -1 se faltar memória.
+ */
+static int selecionarPorHistograma(const Coluna *c, long k, int nThreads,
+                                   long histRaiz[], int *raizPronta, uint64_t *resultado) {
+    PassadaHistograma p;
+    p.coluna = c;
+    p.largura = larguraChave(c->tipo);
+    p.bitsConhecidos = 0;
+    p.prefixo = 0;
+    p.nBlocos = nThreads;
+    p.histogramas = (long*)malloc((size_t)p.nBlocos * DIGITOS * sizeof(long));
+    long *total = (long*)malloc(DIGITOS * sizeof(long));
+    int status = 0;
+    if (p.histogramas == NULL || total == NULL) {
+        free(p.histogramas);
+        free(total);
+        return -1;
+    }
+
+    for (;;) {
+        int blocosContados = 0;   // p.histogramas vale para esta passada?
+        if (p.bitsConhecidos == 0 && *raizPronta) {
+            memcpy(total, histRaiz, DIGITOS * sizeof(long));
+        } else {
+            executarEmParalelo(p.nBlocos, nThreads, contarBloco, &p);
+            blocosContados = 1;
+            memset(total, 0, DIGITOS * sizeof(long));
+            for (int b = 0; b < p.nBlocos; b++)
+                for (int d = 0; d < DIGITOS; d++) total[d] += p.histogramas[(size_t)b * DIGITOS + d];
+            if (p.bitsConhecidos == 0) {
+                memcpy(histRaiz, total, DIGITOS * sizeof(long));
+                *raizPronta = 1;
+            }
+        }
+
+        int d = 0;
+        while (k > total[d]) k -= total[d++];
+        long candidatos = total[d];
+        int restantes = p.largura - p.bitsConhecidos - 16;   // bits ainda indefinidos
+
+        if (restantes == 0) {
+            *resultado = (p.prefixo << 16) | (uint64_t)d;
+            break;
+        }
+        if (candidatos <= LIMITE_CANDIDATOS && restantes <= 32) {
+            // Coleta paralela: cada bloco sabe quantos candidatos tem.
+            if (!blocosContados) executarEmParalelo(p.nBlocos, nThreads, contarBloco, &p);
+            p.digito = d;
+            p.candidatos = (uint64_t*)malloc((size_t)candidatos * sizeof(uint64_t));
+            p.deslocamentos = (long*)malloc((size_t)p.nBlocos * sizeof(long));
+            int *baixas = (int*)malloc((size_t)candidatos * sizeof(int));
+            if (p.candidatos == NULL || p.deslocamentos == NULL || baixas == NULL) {
+                free(p.candidatos);
+                free(p.deslocamentos);
+                free(baixas);
+                status = -1;
+                break;
+            }
+            long acumulado = 0;
+            for (int b = 0; b < p.nBlocos; b++) {
+                p.deslocamentos[b] = acumulado;
+                acumulado += p.histogramas[(size_t)b * DIGITOS + d];
+            }
+            executarEmParalelo(p.nBlocos, nThreads, coletarBloco, &p);
+
+            uint64_t mascara = restantes == 32 ? 0xFFFFFFFFull : ((1ull << restantes) - 1);
+            for (long i = 0; i < candidatos; i++)
+                baixas[i] = metadeComoInt((uint32_t)(p.candidatos[i] & mascara));
+            int baixa = kesimoMinimo(baixas, 0, (int)candidatos - 1, (int)k);
+            *resultado = (((p.prefixo << 16) | (uint64_t)d) << restantes)
+                        | ((uint32_t)baixa ^ 0x80000000u);
+            free(baixas);
+            free(p.candidatos);
+            free(p.deslocamentos);
+            break;
+        }
+
+        p.prefixo = (p.prefixo << 16) | (uint64_t)d;
+        p.bitsConhecidos += 16;
+    }
+
+    free(total);
+    free(p.histogramas);
+    return status;
+}
+
+/* ===================== Leitura da coluna ===================== */
+
+// Mapeia o arquivo inteiro para leitura; arquivos vazios são rejeitados.
+static int mapearArquivo(const char *arquivo, const void **dados, size_t *bytes) {
+    int fd = open(arquivo, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return -1;
+    }
+    void *mapa = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) return -1;
+    *dados = mapa;
+    *bytes = st.st_size;
+    return 0;
+}
+
+static int abrirBinario(const char *arquivo, TipoColuna tipo, Coluna *c) {
+    const void *dados;
+    size_t bytes;
+    if (mapearArquivo(arquivo, &dados, &bytes) != 0) return -1;
+
+    size_t tamElem = larguraChave(tipo) / 8;
+    if (bytes % tamElem != 0) {
+        fprintf(stderr, "'%s': %zu bytes nao e multiplo de %zu (tamanho do elemento)\n",
+                arquivo, bytes, tamElem);
+        munmap((void*)dados, bytes);
+        return -1;
+    }
+    c->tipo = tipo;
+    c->dados = dados;
+    c->bytes = bytes;
+    c->n = (long)(bytes / tamElem);
+    c->mapeado = 1;
+    return 0;
+}
+
+static int ehSeparador(char ch) {
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == ',';
+}
+
+/*
+ * abrirTexto: lê números separados por espaço/linha. Inteiros viram
+ * i64 e reais viram f64 (o tipo pedido só escolhe entre inteiro e real).
+ * O arquivo é mapeado e percorrido uma vez, sem cópia intermediária.
+ * Tokens malformados ("abc", "1e5" como inteiro) e inteiros fora do
+ * intervalo de int64_t são rejeitados com mensagem.
+ */
+static int abrirTexto(const char *arquivo, TipoColuna tipo, Coluna *c) {
+    const void *mapa;
+    size_t bytes;
+    if (mapearArquivo(arquivo, &mapa, &bytes) != 0) return -1;
+    const char *p = (const char*)mapa, *fim = p + bytes;
+    int real = tipo == TIPO_F32 || tipo == TIPO_F64;
+
+    long capacidade = 1 << 16, n = 0;
+    void *valores = malloc(capacidade * 8);
+    if (valores == NULL) {
+        munmap((void*)mapa, bytes);
+        return -1;
+    }
+    while (p < fim) {
+        while (p < fim && ehSeparador(*p)) p++;
+        if (p >= fim) break;
+        if (n == capacidade) {
+            void *maior = realloc(valores, (size_t)capacidade * 2 * 8);
+            if (maior == NULL) goto falha;
+            valores = maior;
+            capacidade *= 2;
+        }
+        const char *token = p;
+        if (real) {
+            while (p < fim && !ehSeparador(*p)) p++;
+            char tmp[64], *resto;
+            if (p - token > 63) goto invalido;
+            memcpy(tmp, token, p - token);
+            tmp[p - token] = '\0';
+            errno = 0;
+            double x = strtod(tmp, &resto);
+            if (resto == tmp || *resto != '\0' || (errno == ERANGE && fabs(x) == HUGE_VAL))
+                goto invalido;
+            ((double*)valores)[n++] = x;
+        } else {
+            // inteiro: laço próprio, bem mais rápido que strtoll por valor
+            int negativo = 0;
+            if (*p == '-' || *p == '+') negativo = *p++ == '-';
+            const char *digitos = p;
+            uint64_t v = 0, limite = negativo ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+            while (p < fim && *p >= '0' && *p <= '9') {
+                uint64_t digito = (uint64_t)(*p++ - '0');
+                if (v > (limite - digito) / 10) goto invalido;
+                v = v * 10 + digito;
+            }
+            if (p == digitos || (p < fim && !ehSeparador(*p))) goto invalido;
+            ((int64_t*)valores)[n++] = negativo ? (int64_t)(0 - v) : (int64_t)v;
+        }
+        continue;
+    invalido:
+        while (p < fim && !ehSeparador(*p)) p++;
+        fprintf(stderr, "'%s': valor invalido na posicao %ld: '%.*s'\n",
+                arquivo, n + 1, p - token > 40 ? 40 : (int)(p - token), token);
+        goto falha;
+    }
+    if (n == 0) goto falha;
+    munmap((void*)mapa, bytes);
+
+    c->tipo = real ? TIPO_F64 : TIPO_I64;
+    c->dados = valores;
+    c->n = n;
+    c->bytes = (size_t)n * 8;
+    c->mapeado = 0;
+    return 0;
+
+falha:
+    free(valores);
+    munmap((void*)mapa, bytes);
+    return -1;
+}
+
+/* ===================== Programa ===================== */
+
+static double agoraSegundos(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void usoCli(const char *programa) {
+    fprintf(stderr, "uso: %s ARQUIVO [--tipo i32|i64|f32|f64] [--texto] "
+                    "[--modo auto|memoria|paralelo|externo] [--threads N] (-k K | -p P)...\n",
+            programa);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        usoCli(argv[0]);
+        return 1;
+    }
+
+    const char *arquivo = argv[1];
+    TipoColuna tipo = TIPO_I32;
+    int texto = 0, nThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *modo = "auto";
+    int nk = 0;
+    long *ksPedidos = (long*)malloc((size_t)argc * sizeof(long));
+    double *percentis = (double*)malloc((size_t)argc * sizeof(double)); // < 0 quando veio de -k
+    if (ksPedidos == NULL || percentis == NULL) {
+        fprintf(stderr, "sem memoria\n");
+        return 1;
+    }
+
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--tipo") && i + 1 < argc) {
+            const char *t = argv[++i];
+            if (!strcmp(t, "i32")) tipo = TIPO_I32;
+            else if (!strcmp(t, "i64")) tipo = TIPO_I64;
+            else if (!strcmp(t, "f32")) tipo = TIPO_F32;
+            else if (!strcmp(t, "f64")) tipo = TIPO_F64;
+            else { usoCli(argv[0]); return 1; }
+        } else if (!strcmp(argv[i], "--texto")) {
+            texto = 1;
+        } else if (!strcmp(argv[i], "--modo") && i + 1 < argc) {
+            modo = argv[++i];
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            nThreads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-k") && i + 1 < argc) {
+            ksPedidos[nk] = atol(argv[++i]);
+            percentis[nk++] = -1.0;
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            percentis[nk++] = atof(argv[++i]);
+        } else {
+            usoCli(argv[0]);
+            return 1;
+        }
+    }
+    if (nk == 0 || nThreads < 1) {
+        usoCli(argv[0]);
+        return 1;
+    }
+
+    double t0 = agoraSegundos();
+    Coluna c;
+    if ((texto ? abrirTexto(arquivo, tipo, &c) : abrirBinario(arquivo, tipo, &c)) != 0) {
+        fprintf(stderr, "nao foi possivel ler '%s'\n", arquivo);
+        free(ksPedidos);
+        free(percentis);
+        return 1;
+    }
+    double tCarga = agoraSegundos() - t0;
+
+    // Converte percentis em k e valida
+    for (int q = 0; q < nk; q++) {
+        if (percentis[q] >= 0.0) {
+            if (percentis[q] > 100.0) percentis[q] = 100.0;
+            ksPedidos[q] = (long)ceil(percentis[q] / 100.0 * c.n);
+            if (ksPedidos[q] < 1) ksPedidos[q] = 1;
+        }
+        if (ksPedidos[q] < 1 || ksPedidos[q] > c.n) {
+            fprintf(stderr, "k = %ld fora de [1, %ld]\n", ksPedidos[q], c.n);
+            return 1;
+        }
+    }
+
+    // Escolha do modo
+    if (!strcmp(modo, "auto")) {
+        double ramLivre = (double)sysconf(_SC_AVPHYS_PAGES) * sysconf(_SC_PAGESIZE);
+        if (c.mapeado && c.bytes > ramLivre / 2) modo = "externo";
+        else if (c.n >= (1L << 24) || c.n > INT_MAX) modo = "paralelo";
+        else modo = "memoria";
+    }
+    if (!strcmp(modo, "memoria") && c.n > INT_MAX) {
+        fprintf(stderr, "modo memoria limitado a %d elementos; usando paralelo\n", INT_MAX);
+        modo = "paralelo";
+    }
+
+    uint64_t *resultados = (uint64_t*)malloc((size_t)nk * sizeof(uint64_t));
+    if (resultados == NULL) {
+        fprintf(stderr, "sem memoria\n");
+        return 1;
+    }
+    double tInicio = agoraSegundos();
+    int status = 0;
+    if (!strcmp(modo, "memoria")) {
+        status = selecionarEmMemoria(&c, ksPedidos, nk, resultados);
+    } else if (!strcmp(modo, "paralelo") || !strcmp(modo, "externo")) {
+        if (!strcmp(modo, "externo") && c.mapeado)
+            madvise((void*)c.dados, c.bytes, MADV_SEQUENTIAL);
+        long *histRaiz = (long*)malloc(DIGITOS * sizeof(long));
+        int raizPronta = 0;
+        if (histRaiz == NULL) status = -1;
+        for (int q = 0; q < nk && status == 0; q++)
+            status = selecionarPorHistograma(&c, ksPedidos[q], nThreads, histRaiz, &raizPronta,
+                                             &resultados[q]);
+        free(histRaiz);
+    } else {
+        usoCli(argv[0]);
+        return 1;
+    }
+    if (status != 0) {
+        fprintf(stderr, "sem memoria\n");
+        return 1;
+    }
+    double tSelecao = agoraSegundos() - tInicio;
+
+    printf("arquivo: %s  n: %ld  modo: %s  threads: %d\n", arquivo, c.n, modo,
+           !strcmp(modo, "memoria") ? 1 : nThreads);
+    for (int q = 0; q < nk; q++) {
+        if (percentis[q] >= 0.0) printf("p%g (k=%ld): ", percentis[q], ksPedidos[q]);
+        else printf("k=%ld: ", ksPedidos[q]);
+        imprimirValor(c.tipo, resultados[q]);
+        printf("\n");
+    }
+    printf("tempo: carga %.3f s, selecao %.3f s\n", tCarga, tSelecao);
+
+    if (c.mapeado) munmap((void*)c.dados, c.bytes);
+    else free((void*)c.dados);
+    free(resultados);
+    free(ksPedidos);
+    free(percentis);
+    return 0;
+}
@@ -0,0 +1,228 @@
+#define KESIMO_SEM_MAIN
+#include "kesimo.c"
+#define STRASSEN_SEM_MAIN
+#include "strassen.c"
+
+#include <string.h>
+
+/*
+ * k vizinhos mais próximos (exato), combinando Strassen e seleção.
+ *
+ * Compilar com: gcc -O2 -pthread knn.c -o knn -lm
+ *
+ * Distância ao quadrado entre a consulta a e o ponto b:
+ *     ||a - b||² = ||a||² + ||b||² - 2 a·b
+ * Os produtos a·b de um bloco de BLOCO_KNN consultas contra um bloco de
+ * BLOCO_KNN pontos formam um produto de matrizes, calculado com strassen
+ * sobre fatias BLOCO_KNN x BLOCO_KNN da dimensão (completadas com zeros).
+ * Assim que um bloco de distâncias fica pronto, cada consulta junta
+ * aos seus k melhores até agora só as distâncias menores que a k-ésima
+ * atual, e seleciona de novo os k menores com kesimoMinimo. A matriz
+ * completa nq x nr nunca existe: só um bloco de cada vez.
+ *
+ * As coordenadas e distâncias são int (como no resto do projeto):
+ * d * (maior diferença)² precisa caber em um int.
+ */
+
+#define BLOCO_KNN 32   // potência de 2 (exigência de strassen)
+
+typedef struct {
+    int nq, nr, d, k;
+    int **Q, **R;
+    int **indices, **distancias;
+    int *normasR;       // ||b||² de cada ponto
+    int fatias;         // ceil(d / BLOCO_KNN)
+    atomic_int falhou;  // alguma tarefa ficou sem memória
+} Knn;
+
+typedef struct {
+    int dist, idx;
+} Vizinho;
+
+static int compararVizinhos(const void *a, const void *b) {
+    const Vizinho *x = (const Vizinho*)a, *y = (const Vizinho*)b;
+    if (x->dist != y->dist) return x->dist < y->dist ? -1 : 1;
+    return (x->idx > y->idx) - (x->idx < y->idx);
+}
+
+/*
+ * Junta 'novos' candidatos (distância, índice) aos 'atuais' melhores de
+ * uma consulta e mantém os k menores em melhoresDist/melhoresIdx.
+ * *limiar recebe a k-ésima menor distância (INT_MAX enquanto houver
+ * menos de k): candidatos com distância >= *limiar já não entram.
+ */
+static int juntarCandidatos(int k, int *melhoresDist, int *melhoresIdx, int atuais,
+                            const int *novosDist, const int *novosIdx, int novos,
+                            int *tmpDist, int *tmpIdx, int *copia, int *limiar) {
+    int m = 0;
+    for (int i = 0; i < atuais; i++) { tmpDist[m] = melhoresDist[i]; tmpIdx[m++] = melhoresIdx[i]; }
+    // empates com o limiar perdem: os índices novos são maiores que os atuais
+    for (int i = 0; i < novos; i++)
+        if (novosDist[i] < *limiar) { tmpDist[m] = novosDist[i]; tmpIdx[m++] = novosIdx[i]; }
+    if (m == atuais) return atuais;
+
+    if (m <= k) {
+        memcpy(melhoresDist, tmpDist, m * sizeof(int));
+        memcpy(melhoresIdx, tmpIdx, m * sizeof(int));
+        if (m == k) {
+            memcpy(copia, tmpDist, m * sizeof(int));
+            *limiar = kesimoMinimo(copia, 0, m - 1, k);
+        }
+        return m;
+    }
+
+    // limiar = k-ésima menor distância; fica tudo < limiar e o que faltar == limiar
+    memcpy(copia, tmpDist, m * sizeof(int));
+    *limiar = kesimoMinimo(copia, 0, m - 1, k);
+    int t = 0;
+    for (int i = 0; i < m; i++)
+        if (tmpDist[i] < *limiar) { melhoresDist[t] = tmpDist[i]; melhoresIdx[t++] = tmpIdx[i]; }
+    for (int i = 0; i < m && t < k; i++)
+        if (tmpDist[i] == *limiar) { melhoresDist[t] = tmpDist[i]; melhoresIdx[t++] = tmpIdx[i]; }
+    return k;
+}
+
+// Processa um bloco de consultas contra todos os blocos de pontos.
+static void knnBlocoConsultas(void *ctx, int tarefa) {
+    Knn *p = (Knn*)ctx;
+    int B = BLOCO_KNN;
+    int q0 = tarefa * B;
+    int bq = q0 + B < p->nq ? B : p->nq - q0;
+
+    int ***fatiasQ = (int***)malloc((size_t)p->fatias * sizeof(int**));
+    int *tmpDist = (int*)malloc(((size_t)p->k + B) * sizeof(int));
+    int *tmpIdx = (int*)malloc(((size_t)p->k + B) * sizeof(int));
+    int *copia = (int*)malloc(((size_t)p->k + B) * sizeof(int));
+    Vizinho *ordem = (Vizinho*)malloc((size_t)p->k * sizeof(Vizinho));
+    if (fatiasQ == NULL || tmpDist == NULL || tmpIdx == NULL || copia == NULL || ordem == NULL) {
+        atomic_store(&p->falhou, 1);
+        free(fatiasQ); free(tmpDist); free(tmpIdx); free(copia); free(ordem);
+        return;
+    }
+
+    // Fatias das consultas (bq x B, resto zerado) e suas normas
+    for (int c = 0; c < p->fatias; c++) {
+        fatiasQ[c] = alocarMatriz(B);
+        for (int i = 0; i < bq; i++)
+            for (int j = 0; j < B && c * B + j < p->d; j++) fatiasQ[c][i][j] = p->Q[q0 + i][c * B + j];
+    }
+    int normasQ[BLOCO_KNN];
+    for (int i = 0; i < bq; i++) {
+        normasQ[i] = 0;
+        for (int j = 0; j < p->d; j++) normasQ[i] += p->Q[q0 + i][j] * p->Q[q0 + i][j];
+    }
+
+    int **RT = alocarMatriz(B);        // fatia dos pontos, transposta
+    int **produto = alocarMatriz(B);
+    int **G = alocarMatriz(B);         // a·b do bloco
+    int preenchidos[BLOCO_KNN] = {0};
+    int limiares[BLOCO_KNN];           // k-ésima distância de cada consulta
+    for (int i = 0; i < BLOCO_KNN; i++) limiares[i] = INT_MAX;
+    int distBloco[BLOCO_KNN], idxBloco[BLOCO_KNN];
+
+    for (int r0 = 0; r0 < p->nr; r0 += B) {
+        int br = r0 + B < p->nr ? B : p->nr - r0;
+
+        // G = Q_bloco · R_blocoᵀ, fatia a fatia da dimensão
+        for (int i = 0; i < B; i++) memset(G[i], 0, B * sizeof(int));
+        for (int c = 0; c < p->fatias; c++) {
+            for (int j = 0; j < B; j++) memset(RT[j], 0, B * sizeof(int));
+            for (int i = 0; i < br; i++)
+                for (int j = 0; j < B && c * B + j < p->d; j++) RT[j][i] = p->R[r0 + i][c * B + j];
+            strassen(B, fatiasQ[c], RT, produto);
+            somarMatrizes(B, G, produto, G);
+        }
+
+        // Consome o bloco: cada consulta atualiza seus k melhores
+        for (int i = 0; i < bq; i++) {
+            for (int j = 0; j < br; j++) {
+                distBloco[j] = normasQ[i] + p->normasR[r0 + j] - 2 * G[i][j];
+                idxBloco[j] = r0 + j;
+            }
+            preenchidos[i] = juntarCandidatos(p->k, p->distancias[q0 + i], p->indices[q0 + i],
+                                              preenchidos[i], distBloco, idxBloco, br,
+                                              tmpDist, tmpIdx, copia, &limiares[i]);
+        }
+    }
+
+    // Ordena os k vizinhos de cada consulta por (distância, índice)
+    for (int i = 0; i < bq; i++) {
+        int *dist = p->distancias[q0 + i], *idx = p->indices[q0 + i];
+        for (int a = 0; a < p->k; a++) ordem[a] = (Vizinho){dist[a], idx[a]};
+        qsort(ordem, p->k, sizeof(Vizinho), compararVizinhos);
+        for (int a = 0; a < p->k; a++) { dist[a] = ordem[a].dist; idx[a] = ordem[a].idx; }
+    }
+
+    for (int c = 0; c < p->fatias; c++) liberarMatriz(B, fatiasQ[c]);
+    free(fatiasQ);
+    liberarMatriz(B, RT);
+    liberarMatriz(B, produto);
+    liberarMatriz(B, G);
+    free(tmpDist);
+    free(tmpIdx);
+    free(copia);
+    free(ordem);
+}
+
+/*
+ * knnExato(nq, nr, d, Q, R, k, indices, distancias, nThreads):
+ * - Q: nq consultas (nq x d), R: nr pontos (nr x d), linhas int*.
+ * - indices[i][0..k-1] e distancias[i][0..k-1] (já alocados pelo chamador)
+ *   recebem os k pontos mais próximos da consulta i, em ordem crescente
+ *   de distância ao quadrado (empates pelo menor índice).
+ * - Blocos de consultas são distribuídos entre nThreads threads.
+ * - Retorna 0 em caso de sucesso e -1 para parâmetros inválidos ou
+ *   falta de memória.
+ */
+int knnExato(int nq, int nr, int d, int **Q, int **R, int k,
+             int **indices, int **distancias, int nThreads) {
+    if (nq <= 0 || nr <= 0 || d <= 0 || k <= 0 || k > nr) return -1;
+
+    Knn p;
+    p.nq = nq; p.nr = nr; p.d = d; p.k = k;
+    p.Q = Q; p.R = R;
+    p.indices = indices; p.distancias = distancias;
+    p.fatias = (d + BLOCO_KNN - 1) / BLOCO_KNN;
+    p.normasR = (int*)malloc((size_t)nr * sizeof(int));
+    if (p.normasR == NULL) return -1;
+    atomic_init(&p.falhou, 0);
+    for (int i = 0; i < nr; i++) {
+        p.normasR[i] = 0;
+        for (int j = 0; j < d; j++) p.normasR[i] += R[i][j] * R[i][j];
+    }
+
+    inicializarRedesSelecao();
+    executarEmParalelo((nq + BLOCO_KNN - 1) / BLOCO_KNN, nThreads, knnBlocoConsultas, &p);
+
+    free(p.normasR);
+    return atomic_load(&p.falhou) ? -1 : 0;
+}
+
+/* ===================== Exemplo mínimo de uso ===================== */
+
+#ifndef KNN_SEM_MAIN
+int main() {
+    // 6 pontos no plano e 2 consultas
+    int pontos[6][2] = {{0, 0}, {10, 10}, {1, 1}, {9, 8}, {5, 5}, {0, 2}};
+    int consultas[2][2] = {{0, 1}, {10, 9}};
+    int *R[6], *Q[2];
+    for (int i = 0; i < 6; i++) R[i] = pontos[i];
+    for (int i = 0; i < 2; i++) Q[i] = consultas[i];
+
+    int k = 3;
+    int idx0[3], idx1[3], dist0[3], dist1[3];
+    int *indices[] = {idx0, idx1}, *dist[] = {dist0, dist1};
+
+    knnExato(2, 6, 2, Q, R, k, indices, dist, 1);
+
+    for (int i = 0; i < 2; i++) {
+        printf("Consulta (%d, %d):", consultas[i][0], consultas[i][1]);
+        for (int j = 0; j < k; j++) printf("  ponto %d (d2 = %d)", indices[i][j], dist[i][j]);
+        printf("\n");
+    }
+    // Esperado: consulta (0,1) -> pontos 0, 2, 5 (d2 = 1, 1, 1)
+    //           consulta (10,9) -> pontos 1, 3, 4 (d2 = 1, 2, 41)
+
+    return 0;
+}
+#endif
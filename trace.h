@@ -0,0 +1,130 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/*
+ * Rastreamento opcional das árvores de recursão (strassen, kesimoMinimo).
+ *
+ * Compilando com -DUSAR_TRACE, cada chamada recursiva e cada fase
+ * registram eventos de início/fim (com o tamanho do subproblema e a
+ * thread) num buffer circular próprio de cada thread, sem trava no
+ * caminho quente. TRACE_SALVAR escreve tudo no formato JSON do Chrome
+ * trace, que abre direto no Perfetto (ui.perfetto.dev) ou em
+ * chrome://tracing.
+ *
+ * Sem a flag, as macros não geram código.
+ *
+ * Se uma thread gerar mais que TRACE_CAPACIDADE eventos, os mais antigos
+ * são sobrescritos (o visualizador ignora fins sem início).
+ */
+
+#ifdef USAR_TRACE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifndef TRACE_CAPACIDADE
+#define TRACE_CAPACIDADE (1 << 16)   // eventos por thread
+#endif
+
+typedef struct {
+    const char *nome;   // literal: não copiamos a string
+    long long ts;       // nanossegundos desde o primeiro evento do processo
+    long tamanho;       // tamanho do subproblema (n)
+    char fase;          // 'B' (início) ou 'E' (fim)
+} EventoTrace;
+
+typedef struct BufferTrace {
+    EventoTrace eventos[TRACE_CAPACIDADE];
+    long long total;            // eventos já gravados (posição = total % capacidade)
+    int tid;
+    struct BufferTrace *prox;   // lista global de buffers (para salvar)
+} BufferTrace;
+
+static pthread_mutex_t traceTrava = PTHREAD_MUTEX_INITIALIZER;
+static BufferTrace *traceBuffers = NULL;
+static int traceProximoTid = 1;
+static long long traceOrigem = -1;
+static _Thread_local BufferTrace *traceLocal = NULL;
+static _Thread_local int traceDesligado = 0;   // faltou memória para o buffer desta thread
+
+static long long traceAgora(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// Cria (uma vez por thread) o buffer local e o registra na lista global.
+// Sem memória, o rastreamento fica desligado nesta thread (retorna NULL).
+static BufferTrace *traceBufferLocal(void) {
+    if (traceLocal == NULL) {
+        if (traceDesligado) return NULL;
+        BufferTrace *b = (BufferTrace*)calloc(1, sizeof(BufferTrace));
+        if (b == NULL) {
+            traceDesligado = 1;
+            return NULL;
+        }
+        pthread_mutex_lock(&traceTrava);
+        if (traceOrigem < 0) traceOrigem = traceAgora();
+        b->tid = traceProximoTid++;
+        b->prox = traceBuffers;
+        traceBuffers = b;
+        pthread_mutex_unlock(&traceTrava);
+        traceLocal = b;
+    }
+    return traceLocal;
+}
+
+static void traceRegistrar(const char *nome, char fase, long tamanho) {
+    BufferTrace *b = traceBufferLocal();
+    if (b == NULL) return;
+    EventoTrace *e = &b->eventos[b->total % TRACE_CAPACIDADE];
+    e->nome = nome;
+    e->fase = fase;
+    e->tamanho = tamanho;
+    e->ts = traceAgora() - traceOrigem;
+    b->total++;
+}
+
+/*
+ * traceSalvar: escreve os eventos de todas as threads em 'arquivo'.
+ * Chame depois que as threads rastreadas terminaram.
+ * Retorna 0 em caso de sucesso e -1 se não conseguir abrir o arquivo.
+ */
+static inline int traceSalvar(const char *arquivo) {
+    FILE *f = fopen(arquivo, "w");
+    if (f == NULL) return -1;
+
+    fprintf(f, "{\"traceEvents\": [");
+    int primeiro = 1;
+    pthread_mutex_lock(&traceTrava);
+    for (BufferTrace *b = traceBuffers; b != NULL; b = b->prox) {
+        long long inicio = b->total > TRACE_CAPACIDADE ? b->total - TRACE_CAPACIDADE : 0;
+        for (long long i = inicio; i < b->total; i++) {
+            const EventoTrace *e = &b->eventos[i % TRACE_CAPACIDADE];
+            fprintf(f, "%s\n  {\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, "
+                       "\"tid\": %d, \"args\": {\"n\": %ld}}",
+                    primeiro ? "" : ",", e->nome, e->fase, e->ts / 1000.0, b->tid, e->tamanho);
+            primeiro = 0;
+        }
+    }
+    pthread_mutex_unlock(&traceTrava);
+    fprintf(f, "\n], \"displayTimeUnit\": \"ns\"}\n");
+    fclose(f);
+    return 0;
+}
+
+#define TRACE_INICIO(nome, n) traceRegistrar(nome, 'B', (long)(n))
+#define TRACE_FIM(nome, n) traceRegistrar(nome, 'E', (long)(n))
+#define TRACE_SALVAR(arquivo) traceSalvar(arquivo)
+
+#else
+
+#define TRACE_INICIO(nome, n) ((void)0)
+#define TRACE_FIM(nome, n) ((void)0)
+#define TRACE_SALVAR(arquivo) ((void)0)
+
+#endif
+
+#endif